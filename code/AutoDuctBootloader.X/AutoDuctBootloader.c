@@ -4,6 +4,7 @@
 #include "HardwareProfile.h"
 #include "uart2.h"
 #include "uart1.h"
+#include "UartDMA.h"
 #include "circbuffer.h"
 #include <plib.h>
 #include <proc/p32mx150f128b.h>
@@ -11,6 +12,10 @@
 #include "BTCom.h"
 #include "BTComCallbacksBootloader.h"
 #include "BootLoader.h"
+#include "NVMem.h"
+#include "LZSS.h"
+#include "CRC16.h"
+#include "SoftTimer.h"
 
 
 // original config
@@ -52,9 +57,8 @@
 //  6 digits - date: YYMMDD
 //  1 digit  - minor FW version
 
-const char __attribute__((space(prog),address(BOOTCODE_FWSTRING_BASE_ADDRESS)))  FW_VERS_STRING[] = "01bc220922.0";        // 13 chars
+const char __attribute__((space(prog),address(BOOTCODE_FWSTRING_BASE_ADDRESS),keep))  FW_VERS_STRING[] = "01bc220922.0";        // 13 chars
 
-#define PROGRAM_BLOCK_SIZE          64
 
 #define BOOTCODE_INIT         0x00
 #define BOOTCODE_ACTIVE       0x01
@@ -66,6 +70,7 @@ const char __attribute__((space(prog),address(BOOTCODE_FWSTRING_BASE_ADDRESS)))
 #define BOOTCODE_RES_PRGM_DONE      0x03
 #define BOOTCODE_RES_SYNTAX_ERR     0x04
 #define BOOTCODE_RES_IMAGE_INVALID  0x05
+#define BOOTCODE_RES_FLASH_ERR      0x06
 
 
 
@@ -73,6 +78,15 @@ const char __attribute__((space(prog),address(BOOTCODE_FWSTRING_BASE_ADDRESS)))
                                             // (allows FW update after reset even if main app is corrupt)
 
 
+// image data format (header blocks of older images are zero padded)
+#define IMAGE_FORMAT_RAW            0x00
+#define IMAGE_FORMAT_LZSS           0x4C    // LZSS stream, size = decompressed size
+#define IMAGE_FORMAT_DELTA          0x44    // LZSS compressed delta against the installed image
+
+// delta stream operations, producing the new image in sequence
+#define DELTA_OP_COPY               0x00    // src(3) len(2): copy from the installed image
+#define DELTA_OP_DATA               0x01    // len(2) data...
+
 #pragma pack(push,2)
 typedef struct imageHeader_TD
 {
@@ -80,25 +94,70 @@ typedef struct imageHeader_TD
         DWORD size;				// size of image in bytes (excluding header)
         //time_t	builddate;		// timecode of build date
         INT64       builddate;		// timecode of build date
-		WORD crc16;				// CRC16 checksum (image only)
+		WORD crc16;				// CRC16 checksum (image only), checked for LZSS and delta
 		char FWrevstr[13];		// Firmware revision string         
+		BYTE format;			// image data format, see IMAGE_FORMAT_xxx
+		WORD baseCrc16;			// delta: CRC16 of the installed image
+		DWORD baseSize;			// delta: size of the installed image
 }imageHeader;
 #pragma pack(pop) // disables the effect of #pragma pack from now on
 
 
 BYTE Bootcode_state = BOOTCODE_INIT;
 WORD Bootcode_expected_Block = 0x0000;
-WORD Bootcode_cnt = 0;
+SoftTimerStruct Bootcode_timer;     // delay before the user app is started
 cfg_bootcode_struct cfg_bootcode;
 
-BYTE LEDblink_state = 0;
-WORD LEDblink_cnt = 0;
+SoftTimerStruct LEDblink_timer;     // periodic LED toggle timer
+
+// flash row staging buffer, programmed with one NVMemWriteRow() operation
+static DWORD rowBuffer[ROW_SIZE_PIC32MX1];
+static DWORD rowAddress = 0;        // flash address of the staged row, 0 = none
+
+// pages are erased on demand, up to the end of the image
+static DWORD eraseAddress;          // first page not erased yet
+static DWORD eraseEnd;              // end of the last page of the image
+
+// windowed transfer (CMD_DEV_PROGRAM_WINDOW): blocks received ahead of
+// Bootcode_expected_Block, bit i of windowMap = block expected + i stored
+static BYTE windowData[BOOTCODE_WINDOW][PROGRAM_BLOCK_SIZE];
+static BYTE windowLen[BOOTCODE_WINDOW];
+static DWORD windowMap;
+
+// compressed images are decompressed into the row programming path
+static BYTE imageFormat;
+static DWORD imageSize;             // decompressed size
+static DWORD imageOffset;           // decompressed bytes programmed
+static WORD imageCrc;               // CRC16 of the image (header block)
+static LZSSDecoderStruct lzss;
+static BYTE lzssWindow[LZSS_WINDOW_SIZE];
+static BYTE lzssChunk[BYTE_ROW_SIZE_PIC32MX1];
+
+// delta images: each page of the new image is assembled in RAM from the
+// installed one before it is erased. The old contents of the last
+// DELTA_BACKUP_PAGES rewritten pages are kept in RAM, copies may read from
+// these, the page being assembled or behind it (code moved up by an update).
+// the backup is the largest RAM user (8 KB of about 20 KB data+bss, 32 KB
+// RAM), tools/otapack.py builds deltas for the same number of pages
+#define DELTA_BACKUP_PAGES          8
+
+static BYTE deltaPage[FLASH_PAGE_SIZE_PIC32MX1];
+static BYTE deltaBackup[DELTA_BACKUP_PAGES][FLASH_PAGE_SIZE_PIC32MX1];
+static DWORD deltaPageAddress;      // flash page in deltaPage
+static DWORD deltaBaseSize;
+static BYTE deltaCmd[6];            // operation being received
+static BYTE deltaCmdLen;
+static WORD deltaDataLen;           // DATA bytes to follow
+
+#define LEDBLINK_PERIOD_FAST    SOFTTIMER_MS(80)
+#define LEDBLINK_PERIOD_SLOW    SOFTTIMER_MS(500)
 
-char txt[256];
+char txt[40];
 
 
 
 static void InitializeBoard(void);
+static void Bootloader_putHex(const char *label, DWORD val, BYTE digits);
 BOOL CheckTrigger(void);
 void JumpToApp(void);
 BOOL ValidAppPresent(void);
@@ -155,6 +214,10 @@ BOOL ValidAppPresent(void);
 //      Uart1TxStringPolled(" at 0x");
 //      Uart1TxUint32HexPolled(_excep_addr);
 //      Uart1TxStringPolled("\r\n");
+
+      // interrupts are off here, send the message by polling
+      UartDMA_Flush(UARTDMA_UART2);
+
       while (1) 
       {
           asm("nop");
@@ -168,106 +231,171 @@ BOOL ValidAppPresent(void);
 
 
 
-void UserInput_Task(void *pvParameters, BYTE *skiprate)
+void UserInput_Task(void *pvParameters, DWORD *skiprate)
 {
     BTCom_Task();
     
     *skiprate = 1;
 }
 
-void LEDblink_Task(void *pvParameters, BYTE *skiprate)
+void LEDblink_toggle()
+{
+    STATLED = !STATLED;
+}
+
+// 0 = off, 1 = blink fast, 2 = blink slow. the LED is toggled by the
+// callback of a periodic software timer
+void LEDblink_setMode(BYTE mode)
 {
-    switch(LEDblink_state)
+    switch(mode)
     {
-        case 0:
-            // do noting
-        break;
         case 1:
             // blink fast
-            if(LEDblink_cnt == 0)
-            {
-                STATLED = !STATLED;
-                LEDblink_cnt = 20;
-            }
-            else
-                LEDblink_cnt--;               
+            SoftTimer_Start(&LEDblink_timer, 1, LEDBLINK_PERIOD_FAST, LEDblink_toggle);
         break;
         case 2:
             // blink slow
-            if(LEDblink_cnt == 0)
-            {
-                STATLED = !STATLED;
-                LEDblink_cnt = 125;
-            }
-            else
-                LEDblink_cnt--;               
+            SoftTimer_Start(&LEDblink_timer, 1, LEDBLINK_PERIOD_SLOW, LEDblink_toggle);
+        break;
+        default:
+            SoftTimer_Stop(&LEDblink_timer);
+            STATLED = 1;    // switch off LED
         break;
-        
     }
-    
-    *skiprate = 1;
 }
 
 
-void LEDblink_setMode(BYTE mode)
+void SaveBootcodeConfig()
 {
-    LEDblink_cnt = 0;
-    LEDblink_state = mode;
-    if(mode == 0)
-        STATLED = 1;    // switch off LED
+    EEPROM_write(BOOTCODE_CONFIG_EEPROM_ADD, &cfg_bootcode, sizeof(cfg_bootcode_struct));
 }
 
-void LEDblink_toggle()
+void LoadBootcodeConfig()
 {
-    STATLED = !STATLED;
+    EEPROM_read(BOOTCODE_CONFIG_EEPROM_ADD, &cfg_bootcode, sizeof(cfg_bootcode_struct));
 }
 
 
-void SaveBootcodeConfig()
+
+
+
+// CRC16 check of the first <size> bytes of the app region: the installed
+// image a delta image was made for, the programmed image before it is
+// marked valid
+BYTE Bootloader_checkImage(DWORD size, WORD crc)
 {
-    EEPROM_write(BOOTCODE_CONFIG_EEPROM_ADD, &cfg_bootcode, sizeof(cfg_bootcode_struct));
+    BYTE *p = (BYTE*)APP_FLASH_START_ADDRESS;
+    WORD crcFlash = CRC16_INIT;
+    WORD n;
+
+    if(size == 0 || size > APP_FLASH_END_ADDRESS + 1 - APP_FLASH_START_ADDRESS)
+    {
+        return 0;
+    }
+
+    while(size > 0)
+    {
+        n = (size > 0x8000) ? 0x8000 : size;
+        crcFlash = CRC16_Update(crcFlash, p, n);
+        p += n;
+        size -= n;
+    }
+
+    return crcFlash == crc;
 }
 
-void LoadBootcodeConfig()
+// debug output "<label><val>", <digits> hex digits. the bootloader does not
+// use sprintf, which would link printf and the 64 bit division (6 KB)
+static void Bootloader_putHex(const char *label, DWORD val, BYTE digits)
 {
-    EEPROM_read(BOOTCODE_CONFIG_EEPROM_ADD, &cfg_bootcode, sizeof(cfg_bootcode_struct));
+    char *p = txt;
+
+    while(*label)
+    {
+        *p++ = *label++;
+    }
+    while(digits--)
+    {
+        *p++ = "0123456789ABCDEF"[(val >> (4*digits)) & 0x0F];
+    }
+    *p++ = '\n';
+    *p++ = '\r';
+    *p = 0;
+
+    DEBUG_puts(txt);
 }
 
+// prepare the user app flash region for an image of <size> bytes. Pages
+// are erased before the first write into them, returns 0 if the image does
+// not fit
+BYTE Bootloader_prepareFlash(DWORD size)
+{
+    if(size == 0 || size > APP_FLASH_END_ADDRESS + 1 - APP_FLASH_START_ADDRESS)
+    {
+        return 0;
+    }
 
+    eraseAddress = APP_FLASH_BASE_ADDRESS;
+    eraseEnd = (APP_FLASH_START_ADDRESS + size + FLASH_PAGE_SIZE_PIC32MX1 - 1) & ~(DWORD)(FLASH_PAGE_SIZE_PIC32MX1 - 1);
+    rowAddress = 0;     // drop a row of an aborted transfer
+    windowMap = 0;
+    imageSize = size;
+    imageOffset = 0;
 
+    Bootloader_putHex("Image Pages:       0x", (eraseEnd - APP_FLASH_BASE_ADDRESS) / FLASH_PAGE_SIZE_PIC32MX1, 4);
 
+    return 1;
+}
 
-// erase complete user app flash region
-void Bootloader_eraseFlash()
+// erase the pages up to <end> that were not erased yet.
+// returns the NVM error status
+UINT Bootloader_erasePages(DWORD end)
 {
-    DWORD i;
-    void* pFlash;
+    UINT res = 0;
 
-    
-    DEBUG_puts("\n\rErasing Flash...");   
-    
-    // erase App Flash region   
-    pFlash = (void*)APP_FLASH_BASE_ADDRESS;									
-    for( i = 0; i < ((APP_FLASH_END_ADDRESS - APP_FLASH_BASE_ADDRESS + 1)/FLASH_PAGE_SIZE_PIC32MX1); i++ )
+    while(eraseAddress < end)
     {
-        NVMemErasePage( pFlash + (i*FLASH_PAGE_SIZE_PIC32MX1) );
-    }	    
-    
-    DEBUG_puts("Done.\n\r");       
+        DEBUG_puts("Erasing Page 0x");
+        UART2PutHexWord( eraseAddress - APP_FLASH_BASE_ADDRESS );
+        DEBUG_puts("\n\r");
+
+        res |= NVMemErasePage((void*)eraseAddress);
+        eraseAddress += FLASH_PAGE_SIZE_PIC32MX1;
+    }
+
+    return res;
 }
 
 
 
 
-BYTE Bootloader_programBlock(DWORD offset, BYTE *data, BYTE size)
+// program the staged row, if any. returns the NVM error status (0 = ok)
+UINT Bootloader_flushRow()
 {
-    DWORD len;
-    DWORD WrData;
-    void* pFlash;
-    BYTE *bptr;
+    UINT res;
+
+    if(rowAddress == 0)
+    {
+        return 0;
+    }
+
+    // erase the page on its first write
+    res = Bootloader_erasePages(rowAddress + BYTE_ROW_SIZE_PIC32MX1);
+    res |= NVMemWriteRow((void*)rowAddress, rowBuffer);
+    rowAddress = 0;
 
-    len = size;
-    bptr = data;
+    return res;
+}
+
+
+// collect a block in the row buffer, complete rows are programmed in one
+// operation. Blocks must arrive in ascending order, the last (partial) row
+// is programmed by Bootloader_flushRow(). returns the NVM error status
+UINT Bootloader_programBlock(DWORD offset, BYTE *data, BYTE size)
+{
+    DWORD address, row;
+    UINT res = 0;
+    WORD n;
     
     //sprintf(txt,"Writing Block 0x%04X...\n\r",offset);
     //DEBUG_puts(txt);       
@@ -277,40 +405,256 @@ BYTE Bootloader_programBlock(DWORD offset, BYTE *data, BYTE size)
     DEBUG_puts("...");  
     
     
-    // set destination base address
-    pFlash = (void*)APP_FLASH_START_ADDRESS + offset;
+    // destination address
+    address = APP_FLASH_START_ADDRESS + offset;
+
+    // only the pages of the image are erased
+    if(address + size > eraseEnd)
+    {
+        DEBUG_puts("beyond image size.\n\r");
+        return 1;
+    }
     
-    while(len > 0)
+    while(size > 0)
     {
-        
-        if(len < 4)
+        row = address & ~(DWORD)(BYTE_ROW_SIZE_PIC32MX1 - 1);
+
+        // block starts a new row: program the last one
+        if(row != rowAddress)
         {
+            res |= Bootloader_flushRow();
 
-            // Sometimes record data length will not be in multiples of 4. Appending 0xFF will make sure that..
-            // we don't write junk data in such cases.
-            WrData = 0xFFFFFFFF;
-            memcpy(&WrData, bptr, len);	
-            len = 0;
+            // unwritten bytes stay erased
+            memset(rowBuffer, 0xFF, sizeof(rowBuffer));
+            rowAddress = row;
         }
-        else
-        {	
-            memcpy(&WrData, bptr, 4);
-            len -= 4;
-        }	        
 
-        // write data word to Flash
-        NVMemWriteWord(pFlash, WrData);
+        n = row + BYTE_ROW_SIZE_PIC32MX1 - address;
+        if(n > size)
+        {
+            n = size;
+        }
+        memcpy((BYTE*)rowBuffer + (address - row), data, n);
 
-        // move data pointers
-        pFlash += 4;
-        bptr += 4;     
+        address += n;
+        data += n;
+        size -= n;
+
+        // row complete
+        if(address == row + BYTE_ROW_SIZE_PIC32MX1)
+        {
+            res |= Bootloader_flushRow();
+        }
 	} 
     
-    DEBUG_puts("Done.\n\r");   
+    DEBUG_puts(res ? "Failed.\n\r" : "Done.\n\r");   
+
+    return res;
+}
+
+
+// start applying a delta image
+void Bootloader_initDelta(DWORD baseSize)
+{
+    deltaBaseSize = baseSize;
+    deltaPageAddress = APP_FLASH_START_ADDRESS & ~(DWORD)(FLASH_PAGE_SIZE_PIC32MX1 - 1);
+    memset(deltaPage, 0xFF, sizeof(deltaPage));
+    deltaCmdLen = 0;
+    deltaDataLen = 0;
+}
+
+// program the assembled page up to <end>. returns the NVM error status
+UINT Bootloader_flushDeltaPage(DWORD end)
+{
+    DWORD address;
+    UINT res = 0;
+    WORD n;
+
+    // the image starts behind the beginning of its first page
+    address = (deltaPageAddress < APP_FLASH_START_ADDRESS) ? APP_FLASH_START_ADDRESS : deltaPageAddress;
+
+    while(address < end)
+    {
+        n = (end - address > BYTE_ROW_SIZE_PIC32MX1) ? BYTE_ROW_SIZE_PIC32MX1 : end - address;
+        res |= Bootloader_programBlock(address - APP_FLASH_START_ADDRESS, &deltaPage[address - deltaPageAddress], n);
+        address += n;
+    }
+
+    return res;
 }
 
+// append a byte to the new image
+BYTE Bootloader_deltaPut(BYTE b)
+{
+    DWORD address = APP_FLASH_START_ADDRESS + imageOffset;
+
+    if(imageOffset >= imageSize)
+    {
+        return BOOTCODE_RES_IMAGE_INVALID;
+    }
+
+    // next page: keep the old contents, program the assembled one
+    if(address >= deltaPageAddress + FLASH_PAGE_SIZE_PIC32MX1)
+    {
+        memcpy(deltaBackup[(deltaPageAddress / FLASH_PAGE_SIZE_PIC32MX1) % DELTA_BACKUP_PAGES],
+               (BYTE*)deltaPageAddress, FLASH_PAGE_SIZE_PIC32MX1);
+
+        if(Bootloader_flushDeltaPage(address))
+        {
+            return BOOTCODE_RES_FLASH_ERR;
+        }
+        deltaPageAddress += FLASH_PAGE_SIZE_PIC32MX1;
+        memset(deltaPage, 0xFF, sizeof(deltaPage));
+    }
+
+    deltaPage[address - deltaPageAddress] = b;
+    imageOffset++;
+
+    return BOOTCODE_RES_OK;
+}
+
+// copy a range of the installed image
+BYTE Bootloader_deltaCopy(DWORD src, WORD len)
+{
+    BYTE res = BOOTCODE_RES_OK;
+    DWORD address;
+    BYTE b;
+
+    if(src + len > deltaBaseSize)
+    {
+        return BOOTCODE_RES_IMAGE_INVALID;
+    }
+
+    while(len-- > 0 && res == BOOTCODE_RES_OK)
+    {
+        address = APP_FLASH_START_ADDRESS + src++;
+
+        if(address >= deltaPageAddress)
+        {
+            // not rewritten yet
+            b = *(BYTE*)address;
+        }
+        else if(address >= deltaPageAddress - DELTA_BACKUP_PAGES * FLASH_PAGE_SIZE_PIC32MX1)
+        {
+            b = deltaBackup[(address / FLASH_PAGE_SIZE_PIC32MX1) % DELTA_BACKUP_PAGES][address & (FLASH_PAGE_SIZE_PIC32MX1 - 1)];
+        }
+        else
+        {
+            // old contents no longer available
+            return BOOTCODE_RES_IMAGE_INVALID;
+        }
+
+        res = Bootloader_deltaPut(b);
+    }
+
+    return res;
+}
 
-void Bootloader_BTcomCallback_Status(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+// execute the decompressed delta operations
+BYTE Bootloader_applyDelta(BYTE *data, WORD n)
+{
+    BYTE res = BOOTCODE_RES_OK;
+    BYTE b;
+
+    while(n-- > 0 && res == BOOTCODE_RES_OK)
+    {
+        b = *data++;
+
+        if(deltaDataLen > 0)
+        {
+            // data of a DATA operation
+            res = Bootloader_deltaPut(b);
+            deltaDataLen--;
+            continue;
+        }
+
+        deltaCmd[deltaCmdLen++] = b;
+
+        if(deltaCmd[0] == DELTA_OP_COPY)
+        {
+            if(deltaCmdLen == 6)
+            {
+                deltaCmdLen = 0;
+                res = Bootloader_deltaCopy(((DWORD)deltaCmd[1] << 16) | ((WORD)deltaCmd[2] << 8) | deltaCmd[3],
+                                           ((WORD)deltaCmd[4] << 8) | deltaCmd[5]);
+            }
+        }
+        else if(deltaCmd[0] == DELTA_OP_DATA)
+        {
+            if(deltaCmdLen == 3)
+            {
+                deltaCmdLen = 0;
+                deltaDataLen = ((WORD)deltaCmd[1] << 8) | deltaCmd[2];
+            }
+        }
+        else
+        {
+            res = BOOTCODE_RES_IMAGE_INVALID;
+        }
+    }
+
+    return res;
+}
+
+// put decompressed image data
+BYTE Bootloader_putImage(BYTE *data, WORD n)
+{
+    if(n > imageSize - imageOffset)
+    {
+        return BOOTCODE_RES_IMAGE_INVALID;
+    }
+
+    if(Bootloader_programBlock(imageOffset, data, n))
+    {
+        return BOOTCODE_RES_FLASH_ERR;
+    }
+    imageOffset += n;
+
+    return BOOTCODE_RES_OK;
+}
+
+
+// program the image data of a block. raw images are programmed at the block
+// offset, compressed ones are decompressed in sequence (blocks must arrive in
+// order). returns a BOOTCODE_RES_xxx code
+BYTE Bootloader_writeImage(DWORD offset, BYTE *data, BYTE size)
+{
+    BYTE res = BOOTCODE_RES_OK;
+    WORD len, n;
+
+    if(imageFormat == IMAGE_FORMAT_RAW)
+    {
+        return Bootloader_programBlock(offset, data, size) ? BOOTCODE_RES_FLASH_ERR : BOOTCODE_RES_OK;
+    }
+
+    // decompress until the block is used up
+    while(res == BOOTCODE_RES_OK)
+    {
+        len = size;
+        n = LZSS_Decode(&lzss, data, &len, lzssChunk, sizeof(lzssChunk));
+        data += len;
+        size -= len;
+
+        if(n == 0)
+        {
+            break;
+        }
+
+        if(imageFormat == IMAGE_FORMAT_DELTA)
+        {
+            res = Bootloader_applyDelta(lzssChunk, n);
+        }
+        else
+        {
+            res = Bootloader_putImage(lzssChunk, n);
+        }
+    }
+
+    return res;
+}
+
+
+void Bootloader_BTcomCallback_Status(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {
 //    FLOAT_VAL   fVal;
 //    WORD_VAL    wVal;
@@ -378,7 +722,7 @@ void Bootloader_BTcomCallback_Status(BYTE *buf_in, BYTE *buf_out, BYTE *response
 
 
 
-void Bootloader_BTcomCallback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+void Bootloader_BTcomCallback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {
     DWORD offset, blockID;
     WORD_VAL wval;
@@ -408,6 +752,7 @@ void Bootloader_BTcomCallback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
         
         Bootcode_expected_Block = 0;
         Bootcode_state = BOOTCODE_ACTIVE;
+        windowMap = 0;
         LEDblink_setMode(2);    // blink slow
 
         DEBUG_puts("Bootcode hook catched. Starting Bootloader mode.\n\r");                
@@ -445,21 +790,38 @@ void Bootloader_BTcomCallback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
             // extract header from first Firmware block
             Header = (imageHeader*)&buf_in[4];
             
-            sprintf(txt,"Image Signature:   %04X\n\r",Header->signature);
-            DEBUG_puts(txt);     
-            sprintf(txt,"Image CRC16:       %04X\n\r",Header->crc16);
-            DEBUG_puts(txt);     
-            sprintf(txt,"Image Size:        %u\n\r",Header->size);
-            DEBUG_puts(txt);         
-
-            if(Header->signature == 0xA2F6)
+            Bootloader_putHex("Image Signature:   ", Header->signature, 4);
+            Bootloader_putHex("Image CRC16:       ", Header->crc16, 4);
+            Bootloader_putHex("Image Size:        0x", Header->size, 8);
+
+            if(Header->signature == 0xA2F6 && Header->format == IMAGE_FORMAT_DELTA &&
+               !Bootloader_checkImage(Header->baseSize, Header->baseCrc16))
+            {
+                // delta against another image, nothing erased
+                DEBUG_puts("Delta base image mismatch!\n\r");
+                buf_out[1] = BOOTCODE_RES_IMAGE_INVALID;
+                Bootcode_state = BOOTCODE_INIT;
+            }
+            else if(Header->signature == 0xA2F6 &&
+               (Header->format == IMAGE_FORMAT_RAW || Header->format == IMAGE_FORMAT_LZSS ||
+                Header->format == IMAGE_FORMAT_DELTA) &&
+               Bootloader_prepareFlash(Header->size))
             {
+                imageFormat = Header->format;
+                imageCrc = Header->crc16;
+                if(imageFormat != IMAGE_FORMAT_RAW)
+                {
+                    DEBUG_puts(imageFormat == IMAGE_FORMAT_DELTA ? "Image Format:      Delta\n\r" : "Image Format:      LZSS\n\r");
+                    LZSS_Init(&lzss, lzssWindow);
+                }
+                if(imageFormat == IMAGE_FORMAT_DELTA)
+                {
+                    Bootloader_initDelta(Header->baseSize);
+                }
+
                 // reset magic number in EEPROM config 
                 cfg_bootcode.magicnumber = MAGIC_NUMBER_INVALID_APP;
                 SaveBootcodeConfig();
-
-                // erase user app flash region
-                Bootloader_eraseFlash();     
                 
             // do not program first block, as it only contains the header
             // padded to 64 Bytes                
@@ -476,7 +838,7 @@ void Bootloader_BTcomCallback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
             }
             else
             {
-                DEBUG_puts("Signature of Image invalid!\n\r");   
+                DEBUG_puts("Signature or size of Image invalid!\n\r");   
                 // return error code
                 buf_out[1] = BOOTCODE_RES_IMAGE_INVALID;
                 Bootcode_state = BOOTCODE_INIT; 
@@ -503,7 +865,32 @@ void Bootloader_BTcomCallback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
             {
                 // dummy block. Image transfer complete.
                 
-                if(ValidAppPresent())
+                // program the last, partial row (delta: page). an image that
+                // did not reach the app reset address must not leave an old one
+                if((imageFormat == IMAGE_FORMAT_DELTA && Bootloader_flushDeltaPage(APP_FLASH_START_ADDRESS + imageOffset)) ||
+                   Bootloader_flushRow() || Bootloader_erasePages(USER_APP_RESET_ADDRESS + 4))
+                {
+                    buf_out[1] = BOOTCODE_RES_FLASH_ERR;
+                    Bootcode_state = BOOTCODE_INIT;
+                }
+                else if(imageFormat != IMAGE_FORMAT_RAW && imageOffset != imageSize)
+                {
+                    // compressed stream ended early
+                    DEBUG_puts("Image incomplete!\n\r");
+                    buf_out[1] = BOOTCODE_RES_IMAGE_INVALID;
+                    Bootcode_state = BOOTCODE_INIT;
+                }
+                else if(imageFormat != IMAGE_FORMAT_RAW && !Bootloader_checkImage(imageSize, imageCrc))
+                {
+                    // flash contents differ from the image. only LZSS and
+                    // delta images (otapack.py) carry a CRC16/CCITT-FALSE
+                    // of the decompressed image, raw ones from older
+                    // packers may not
+                    DEBUG_puts("Image CRC mismatch!\n\r");
+                    buf_out[1] = BOOTCODE_RES_IMAGE_INVALID;
+                    Bootcode_state = BOOTCODE_INIT;
+                }
+                else if(ValidAppPresent())
                 {
                     // update magic number in EEPROM config 
                     cfg_bootcode.magicnumber = MAGIC_NUMBER_VALID_APP;
@@ -513,7 +900,7 @@ void Bootloader_BTcomCallback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
                     buf_out[1] = BOOTCODE_RES_PRGM_DONE;     
 
 
-                    Bootcode_cnt = 50;
+                    SoftTimer_Start(&Bootcode_timer, SOFTTIMER_MS(200), 0, NULL);
                     Bootcode_state = BOOTCODE_START_APP;
                     
                     LEDblink_setMode(1);    // blink fast
@@ -541,14 +928,21 @@ void Bootloader_BTcomCallback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
                 offset = (blockID - 1) * PROGRAM_BLOCK_SIZE;
                 
                 // program block
-                Bootloader_programBlock(offset, &buf_in[4], buf_in[3]);
-
-                Bootcode_expected_Block++;
-                
-                LEDblink_toggle();
+                buf_out[1] = Bootloader_writeImage(offset, &buf_in[4], buf_in[3]);
+                if(buf_out[1] != BOOTCODE_RES_OK)
+                {
+                    Bootcode_state = BOOTCODE_INIT;
+                }
+                else
+                {
+                    Bootcode_expected_Block++;
+                    windowMap >>= 1;    // window starts at the next block
+                    
+                    LEDblink_toggle();
 
-                // return OK code
-                buf_out[1] = BOOTCODE_RES_OK;            
+                    // return OK code
+                    buf_out[1] = BOOTCODE_RES_OK;            
+                }
             }
         
         }
@@ -562,6 +956,7 @@ void Bootloader_BTcomCallback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
     //0x03 = Image programming done, firmware update started
     //0x04 = Error, unexpected syntax
     //0x05 = Error, firmware image invalid
+    //0x06 = Error, flash programming failed
     
 //#define BOOTCODE_RES_OK             0x00
 //#define BOOTCODE_RES_PKT_LOSS       0x01
@@ -579,7 +974,85 @@ void Bootloader_BTcomCallback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
 
 
 
-void cmd_dev_reset_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+// windowed firmware transfer, see CMD_DEV_PROGRAM_WINDOW
+void Bootloader_BTcomCallback_Window(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
+{
+    WORD blockID, ahead;
+    BYTE slot;
+
+    // buf_in[0] = CMD
+    // buf_in[1] = operation
+    // buf_in[2..3] = BlockID (MSB first), buf_in[4] = Data Length
+    // buf_in[5..n] = Data Bytes
+
+    buf_out[1] = BOOTCODE_RES_OK;
+
+    if(Bootcode_state != BOOTCODE_ACTIVE || Bootcode_expected_Block == 0)
+    {
+        // no transfer started, or header block missing
+        buf_out[1] = BOOTCODE_RES_PKT_LOSS;
+    }
+    else if(buf_in[1] == BOOTCODE_WINDOW_DATA)
+    {
+        blockID = ((WORD)buf_in[2] << 8) | buf_in[3];
+        ahead = blockID - Bootcode_expected_Block;
+
+        if(*responseBytes - 1 < 5 || buf_in[4] == 0 || buf_in[4] > PROGRAM_BLOCK_SIZE ||
+           *responseBytes - 1 < 5 + buf_in[4])
+        {
+            buf_out[1] = BOOTCODE_RES_SYNTAX_ERR;
+        }
+        else if(blockID >= Bootcode_expected_Block && ahead < BOOTCODE_WINDOW)
+        {
+            // store block, programmed in order on the next sync.
+            // blocks already programmed or beyond the window are ignored
+            slot = blockID % BOOTCODE_WINDOW;
+            memcpy(windowData[slot], &buf_in[5], buf_in[4]);
+            windowLen[slot] = buf_in[4];
+            windowMap |= (DWORD)1 << ahead;
+        }
+    }
+    else if(buf_in[1] == BOOTCODE_WINDOW_SYNC)
+    {
+        // program the blocks received in sequence. the host waits for this
+        // response, no data is lost while the CPU stalls during flash writes
+        while(windowMap & 1)
+        {
+            slot = Bootcode_expected_Block % BOOTCODE_WINDOW;
+
+            // calculate offset (first block is skipped = header)
+            buf_out[1] = Bootloader_writeImage((DWORD)(Bootcode_expected_Block - 1) * PROGRAM_BLOCK_SIZE,
+                                               windowData[slot], windowLen[slot]);
+            if(buf_out[1] != BOOTCODE_RES_OK)
+            {
+                Bootcode_state = BOOTCODE_INIT;
+                break;
+            }
+
+            Bootcode_expected_Block++;
+            windowMap >>= 1;
+        }
+
+        LEDblink_toggle();
+    }
+    else
+    {
+        buf_out[1] = BOOTCODE_RES_SYNTAX_ERR;
+    }
+
+    // window state: next block to program, bitmap of the blocks behind it
+    buf_out[2] = Bootcode_expected_Block >> 8;
+    buf_out[3] = Bootcode_expected_Block & 0xFF;
+    buf_out[4] = windowMap >> 24;
+    buf_out[5] = windowMap >> 16;
+    buf_out[6] = windowMap >> 8;
+    buf_out[7] = windowMap;
+
+    *responseBytes = 8;
+}
+
+
+void cmd_dev_reset_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {           
     if(cfg_bootcode.magicnumber == MAGIC_NUMBER_UPDATE_REQ)
     {
@@ -628,7 +1101,7 @@ void cmd_dev_reset_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
 
 
 
-void Bootloader_Task(void *pvParameters, BYTE *skiprate)
+void Bootloader_Task(void *pvParameters, DWORD *skiprate)
 {
     
     // TODO:
@@ -655,7 +1128,7 @@ void Bootloader_Task(void *pvParameters, BYTE *skiprate)
                 if(ValidAppPresent())
                 {
                     // execute user app
-                    Bootcode_cnt = BOOTCODE_HOOKING_WINDOW * 250;
+                    SoftTimer_Start(&Bootcode_timer, SOFTTIMER_SEC(BOOTCODE_HOOKING_WINDOW), 0, NULL);
                     Bootcode_state = BOOTCODE_START_APP;
                     LEDblink_setMode(1);    // blink fast
                     
@@ -711,13 +1184,14 @@ void Bootloader_Task(void *pvParameters, BYTE *skiprate)
         case BOOTCODE_START_APP:
             
             // jump to user app after a defined delay
-            if(Bootcode_cnt == 0)
+            if(SoftTimer_Expired(&Bootcode_timer))
             {
+                // finish output and release the DMA before the app takes over
+                UartDMA_Close();
+
                 // execute user app
                 JumpToApp();                
             }
-            else
-                Bootcode_cnt--;
             
             
         break;
@@ -739,6 +1213,7 @@ void Bootloader_Task(void *pvParameters, BYTE *skiprate)
 
 int main(void)
 { 
+    DWORD baud;
    
 	// Initialize application specific hardware
 	InitializeBoard();
@@ -789,16 +1264,29 @@ int main(void)
     Scheduler_Init();    
  
     BTCom_Init();
-    BTCom_SetupCallbacks();
+    // queued requests are answered in the idle time of a tick
+    Scheduler_SetIdleTask(BTCom_IdleTask);
 
     EEPROM_init(0x50);
+
+    // HM-17 UART rate: during a pending firmware update the app's BLE
+    // connection is still active, keep its rate. negotiate otherwise
+    LoadBootcodeConfig();
+    if(cfg_bootcode.magicnumber != MAGIC_NUMBER_UPDATE_REQ || !UART1_HM17UseBaudrate(cfg_bootcode.blebaud))
+    {
+        baud = UART1_HM17Negotiate(cfg_bootcode.blebaud);
+        if(baud != 0 && baud != cfg_bootcode.blebaud)
+        {
+            cfg_bootcode.blebaud = baud;
+            SaveBootcodeConfig();
+        }
+    }
     
     LEDblink_setMode(0);
  
     DEBUG_puts("\n\r\n\rBoard Init complete.\n\r\n\r");        
       
     Scheduler_AddTask(0, Bootloader_Task, NULL, 1, 0);
-    Scheduler_AddTask(1, LEDblink_Task, NULL, 1, 0);
     Scheduler_AddTask(2, UserInput_Task, NULL, 1, 0);        
      
     while(1)
@@ -951,11 +1439,35 @@ static void InitializeBoard(void)
 * Overview: 	Jumps to application.
 *
 *			
-* Note:		 	None.
+* Note:		 	Interrupts are left disabled, the application enables
+*				them after setting up its own vectors.
 ********************************************************************/
 void JumpToApp(void)
 {	
 	void (*fptr)(void);
+
+    // no bootloader ISR must run once the application code executes
+    INTDisableInterrupts();
+
+    // scheduler tick and tickless wake-up interrupt
+    T4CONbits.TON = 0;
+    INTEnable(INT_T4, INT_DISABLED);
+    INTClearFlag(INT_T4);
+
+    // UART receive/transmit and TX DMA interrupts
+    INTEnable(INT_U1RX, INT_DISABLED);
+    INTEnable(INT_U1TX, INT_DISABLED);
+    INTEnable(INT_U2RX, INT_DISABLED);
+    INTEnable(INT_U2TX, INT_DISABLED);
+    INTEnable(INT_SOURCE_DMA(DMA_CHANNEL0), INT_DISABLED);
+    INTEnable(INT_SOURCE_DMA(DMA_CHANNEL1), INT_DISABLED);
+    INTClearFlag(INT_U1RX);
+    INTClearFlag(INT_U1TX);
+    INTClearFlag(INT_U2RX);
+    INTClearFlag(INT_U2TX);
+    INTClearFlag(INT_SOURCE_DMA(DMA_CHANNEL0));
+    INTClearFlag(INT_SOURCE_DMA(DMA_CHANNEL1));
+
 	fptr = (void (*)(void))USER_APP_RESET_ADDRESS;
 	fptr();
 }	
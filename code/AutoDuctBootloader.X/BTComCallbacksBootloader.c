@@ -13,6 +13,7 @@
 #define CMD_UPDATECONFIG	0x05        // new for Wordclock
 #define CMD_FWREV           0x06
 #define CMD_POWERCFG        0x07        // set power mode
+#define CMD_CLOCKSYNC       0x09
 
 #define CMD_DEV_PROGRAM             0xF0
 #define CMD_DEV_RESET               0xF1
@@ -21,12 +22,13 @@
 
 
 // callbacks implemented in AutoDuctBootloader.c
-void Bootloader_BTcomCallback_Status(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes);
-void Bootloader_BTcomCallback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes);
-void cmd_dev_reset_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes);
+void Bootloader_BTcomCallback_Status(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes);
+void Bootloader_BTcomCallback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes);
+void Bootloader_BTcomCallback_Window(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes);
+void cmd_dev_reset_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes);
 
 
-void BTCom_defaultCallback(BYTE *buf_in, BYTE *buf_out, BYTE* len)
+void BTCom_defaultCallback(BYTE *buf_in, BYTE *buf_out, WORD *len)
 {
     //responseBytes = *len-1;  // echo back entire data packet (last data byte is checksum)        
     *len = *len-1;
@@ -102,7 +104,7 @@ void SendFWStringBT(BYTE *inbuf, BYTE *outbuf, WORD *len)
 
 
 
-void cmd_manvent_callback(BYTE *buf_in, BYTE *outbuf, BYTE *responseBytes)
+void cmd_manvent_callback(BYTE *buf_in, BYTE *outbuf, WORD *responseBytes)
 {
     // CMD              buf_in[0]
 
@@ -119,7 +121,7 @@ void cmd_manvent_callback(BYTE *buf_in, BYTE *outbuf, BYTE *responseBytes)
 }
 
         
-void cmd_readconfig_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+void cmd_readconfig_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {
             
     // buf_in[0] = CMD
@@ -130,7 +132,7 @@ void cmd_readconfig_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
 }
 
 
-void cmd_updateconfig_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+void cmd_updateconfig_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {
     //Config_UpdateFragment(buf_in[1], &buf_in[2]);
 
@@ -138,7 +140,7 @@ void cmd_updateconfig_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
 }    
 
 
-void cmd_status_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+void cmd_status_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {
     //DeviceControl_StatusBTCom(buf_out, responseBytes);   
     Bootloader_BTcomCallback_Status(buf_in, buf_out, responseBytes);    
@@ -146,7 +148,7 @@ void cmd_status_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
 }
 
 
-void cmd_clocksync_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+void cmd_clocksync_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {
 //                cmddata[1] = (byte)rnow.get(Calendar.HOUR_OF_DAY);
 //                cmddata[2] = (byte)rnow.get(Calendar.MINUTE);
@@ -164,7 +166,7 @@ void cmd_clocksync_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
 }
 
             
-void cmd_dev_program_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+void cmd_dev_program_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {           
     Bootloader_BTcomCallback(buf_in, buf_out, responseBytes);
 }            
@@ -172,17 +174,23 @@ void cmd_dev_program_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
 
             
 
-void BTCom_SetupCallbacks()
+// command registry, sorted by command ID
+// (request/response lengths including the command byte)
+const CommandStruct BTCom_commands[] =
 {
-    BTCom_addCallback(CMD_RESERVED,     BTCom_defaultCallback);
-    BTCom_addCallback(CMD_MANVENT,      cmd_manvent_callback);   
-    BTCom_addCallback(CMD_STATUS,       cmd_status_callback);   
-    BTCom_addCallback(CMD_READCONFIG,   cmd_readconfig_callback); 
-    BTCom_addCallback(CMD_UPDATECONFIG, cmd_updateconfig_callback); 
-    BTCom_addCallback(CMD_FWREV,        SendFWStringBT); 
-    BTCom_addCallback(CMD_CLOCKSYNC,    cmd_clocksync_callback); 
-    BTCom_addCallback(CMD_DEV_PROGRAM,  cmd_dev_program_callback); 
-    BTCom_addCallback(CMD_DEV_ECHO,     BTCom_defaultCallback); 
-    BTCom_addCallback(CMD_DEV_RESET,    cmd_dev_reset_callback);     
-}
+    //            command                 callback                        request                   response
+    BTCOM_COMMAND(CMD_RESERVED,           BTCom_defaultCallback,          1, BTCOM_LEN_ANY,          BTCOM_LEN_ECHO),
+    BTCOM_COMMAND(CMD_MANVENT,            cmd_manvent_callback,           5, 5,                      1),
+    BTCOM_COMMAND(CMD_STATUS,             cmd_status_callback,            1, 1,                      16),
+    BTCOM_COMMAND(CMD_READCONFIG,         cmd_readconfig_callback,        2, 2,                      1),
+    BTCOM_COMMAND(CMD_UPDATECONFIG,       cmd_updateconfig_callback,      2, BTCOM_LEN_ANY,          1),
+    BTCOM_COMMAND(CMD_FWREV,              SendFWStringBT,                 1, 1,                      13*4 + 1),
+    BTCOM_COMMAND(CMD_CLOCKSYNC,          cmd_clocksync_callback,         9, 9,                      1),
+    BTCOM_COMMAND(CMD_DEV_PROGRAM,        cmd_dev_program_callback,       4, 4 + PROGRAM_BLOCK_SIZE, 2),
+    BTCOM_COMMAND(CMD_DEV_RESET,          cmd_dev_reset_callback,         3, 3,                      2),
+    BTCOM_COMMAND(CMD_DEV_PROGRAM_WINDOW, Bootloader_BTcomCallback_Window, 2, 5 + PROGRAM_BLOCK_SIZE, 8),
+    BTCOM_COMMAND(CMD_DEV_ECHO,           BTCom_defaultCallback,          1, BTCOM_LEN_ANY,          BTCOM_LEN_ECHO),
+};
+
+const WORD BTCom_commandCount = sizeof(BTCom_commands) / sizeof(BTCom_commands[0]);
 
@@ -13,7 +13,28 @@
 #include "UART1.h"
 
 
-void BTCom_SetupCallbacks();
+#define PROGRAM_BLOCK_SIZE          64      // firmware bytes per DEV_PROGRAM block
+
+
+// windowed firmware transfer. After the init sequence and the header block
+// (block 0) were sent with CMD_DEV_PROGRAM, the host streams data blocks
+// ahead without waiting for each response:
+//   CMD_DEV_PROGRAM_WINDOW BOOTCODE_WINDOW_DATA blockID(2) len data...
+// and then requests a sync, which programs all blocks received in sequence:
+//   CMD_DEV_PROGRAM_WINDOW BOOTCODE_WINDOW_SYNC
+// Both return
+//   CMD_DEV_PROGRAM_WINDOW status next(2) bitmap(4)
+// next = first block not programmed yet, bit i of bitmap (MSB first) is set
+// if block next+i was received. The host resends the missing blocks of the
+// window [next, next + BOOTCODE_WINDOW) only. Flash is written during syncs
+// only, the CPU stalls while flash is written and could not receive.
+// The transfer ends with the CMD_DEV_PROGRAM dummy block (block <next>,
+// length 0).
+#define CMD_DEV_PROGRAM_WINDOW      0xF2
+
+#define BOOTCODE_WINDOW             32      // blocks buffered ahead
+#define BOOTCODE_WINDOW_DATA        0x00
+#define BOOTCODE_WINDOW_SYNC        0x01
 
 
 #endif	/* BTCOMCALLBACKSAPP_H */
@@ -57,17 +57,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=AutoDuctBootloader.c BTComCallbacksBootloader.c ../Common/BTCom.c ../Common/CircBuffer.c ../Common/Delay.c ../Common/M24512.c ../Common/NVMem.c ../Common/TaskScheduler.c ../Common/uart1.c ../Common/uart2.c
+SOURCEFILES_QUOTED_IF_SPACED=AutoDuctBootloader.c BTComCallbacksBootloader.c ../Common/BTCom.c ../Common/BTComDecoder.c ../Common/CircBuffer.c ../Common/CRC16.c ../Common/LZSS.c ../Common/Delay.c ../Common/M24512.c ../Common/NVMem.c ../Common/TaskScheduler.c ../Common/SoftTimer.c ../Common/UartDMA.c ../Common/uart1.c ../Common/uart2.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/AutoDuctBootloader.o ${OBJECTDIR}/BTComCallbacksBootloader.o ${OBJECTDIR}/_ext/2108356922/BTCom.o ${OBJECTDIR}/_ext/2108356922/CircBuffer.o ${OBJECTDIR}/_ext/2108356922/Delay.o ${OBJECTDIR}/_ext/2108356922/M24512.o ${OBJECTDIR}/_ext/2108356922/NVMem.o ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o ${OBJECTDIR}/_ext/2108356922/uart1.o ${OBJECTDIR}/_ext/2108356922/uart2.o
-POSSIBLE_DEPFILES=${OBJECTDIR}/AutoDuctBootloader.o.d ${OBJECTDIR}/BTComCallbacksBootloader.o.d ${OBJECTDIR}/_ext/2108356922/BTCom.o.d ${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d ${OBJECTDIR}/_ext/2108356922/Delay.o.d ${OBJECTDIR}/_ext/2108356922/M24512.o.d ${OBJECTDIR}/_ext/2108356922/NVMem.o.d ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d ${OBJECTDIR}/_ext/2108356922/uart1.o.d ${OBJECTDIR}/_ext/2108356922/uart2.o.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/AutoDuctBootloader.o ${OBJECTDIR}/BTComCallbacksBootloader.o ${OBJECTDIR}/_ext/2108356922/BTCom.o ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o ${OBJECTDIR}/_ext/2108356922/CircBuffer.o ${OBJECTDIR}/_ext/2108356922/CRC16.o ${OBJECTDIR}/_ext/2108356922/LZSS.o ${OBJECTDIR}/_ext/2108356922/Delay.o ${OBJECTDIR}/_ext/2108356922/M24512.o ${OBJECTDIR}/_ext/2108356922/NVMem.o ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o ${OBJECTDIR}/_ext/2108356922/SoftTimer.o ${OBJECTDIR}/_ext/2108356922/UartDMA.o ${OBJECTDIR}/_ext/2108356922/uart1.o ${OBJECTDIR}/_ext/2108356922/uart2.o
+POSSIBLE_DEPFILES=${OBJECTDIR}/AutoDuctBootloader.o.d ${OBJECTDIR}/BTComCallbacksBootloader.o.d ${OBJECTDIR}/_ext/2108356922/BTCom.o.d ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o.d ${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d ${OBJECTDIR}/_ext/2108356922/CRC16.o.d ${OBJECTDIR}/_ext/2108356922/LZSS.o.d ${OBJECTDIR}/_ext/2108356922/Delay.o.d ${OBJECTDIR}/_ext/2108356922/M24512.o.d ${OBJECTDIR}/_ext/2108356922/NVMem.o.d ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d ${OBJECTDIR}/_ext/2108356922/SoftTimer.o.d ${OBJECTDIR}/_ext/2108356922/UartDMA.o.d ${OBJECTDIR}/_ext/2108356922/uart1.o.d ${OBJECTDIR}/_ext/2108356922/uart2.o.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/AutoDuctBootloader.o ${OBJECTDIR}/BTComCallbacksBootloader.o ${OBJECTDIR}/_ext/2108356922/BTCom.o ${OBJECTDIR}/_ext/2108356922/CircBuffer.o ${OBJECTDIR}/_ext/2108356922/Delay.o ${OBJECTDIR}/_ext/2108356922/M24512.o ${OBJECTDIR}/_ext/2108356922/NVMem.o ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o ${OBJECTDIR}/_ext/2108356922/uart1.o ${OBJECTDIR}/_ext/2108356922/uart2.o
+OBJECTFILES=${OBJECTDIR}/AutoDuctBootloader.o ${OBJECTDIR}/BTComCallbacksBootloader.o ${OBJECTDIR}/_ext/2108356922/BTCom.o ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o ${OBJECTDIR}/_ext/2108356922/CircBuffer.o ${OBJECTDIR}/_ext/2108356922/CRC16.o ${OBJECTDIR}/_ext/2108356922/LZSS.o ${OBJECTDIR}/_ext/2108356922/Delay.o ${OBJECTDIR}/_ext/2108356922/M24512.o ${OBJECTDIR}/_ext/2108356922/NVMem.o ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o ${OBJECTDIR}/_ext/2108356922/SoftTimer.o ${OBJECTDIR}/_ext/2108356922/UartDMA.o ${OBJECTDIR}/_ext/2108356922/uart1.o ${OBJECTDIR}/_ext/2108356922/uart2.o
 
 # Source Files
-SOURCEFILES=AutoDuctBootloader.c BTComCallbacksBootloader.c ../Common/BTCom.c ../Common/CircBuffer.c ../Common/Delay.c ../Common/M24512.c ../Common/NVMem.c ../Common/TaskScheduler.c ../Common/uart1.c ../Common/uart2.c
+SOURCEFILES=AutoDuctBootloader.c BTComCallbacksBootloader.c ../Common/BTCom.c ../Common/BTComDecoder.c ../Common/CircBuffer.c ../Common/CRC16.c ../Common/LZSS.c ../Common/Delay.c ../Common/M24512.c ../Common/NVMem.c ../Common/TaskScheduler.c ../Common/SoftTimer.c ../Common/UartDMA.c ../Common/uart1.c ../Common/uart2.c
 
 
 
@@ -111,122 +111,182 @@ ${OBJECTDIR}/AutoDuctBootloader.o: AutoDuctBootloader.c  nbproject/Makefile-${CN
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/AutoDuctBootloader.o.d 
 	@${RM} ${OBJECTDIR}/AutoDuctBootloader.o 
-	@${FIXDEPS} "${OBJECTDIR}/AutoDuctBootloader.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/AutoDuctBootloader.o.d" -o ${OBJECTDIR}/AutoDuctBootloader.o AutoDuctBootloader.c  
+	@${FIXDEPS} "${OBJECTDIR}/AutoDuctBootloader.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/AutoDuctBootloader.o.d" -o ${OBJECTDIR}/AutoDuctBootloader.o AutoDuctBootloader.c  
 	
 ${OBJECTDIR}/BTComCallbacksBootloader.o: BTComCallbacksBootloader.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/BTComCallbacksBootloader.o.d 
 	@${RM} ${OBJECTDIR}/BTComCallbacksBootloader.o 
-	@${FIXDEPS} "${OBJECTDIR}/BTComCallbacksBootloader.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/BTComCallbacksBootloader.o.d" -o ${OBJECTDIR}/BTComCallbacksBootloader.o BTComCallbacksBootloader.c  
+	@${FIXDEPS} "${OBJECTDIR}/BTComCallbacksBootloader.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/BTComCallbacksBootloader.o.d" -o ${OBJECTDIR}/BTComCallbacksBootloader.o BTComCallbacksBootloader.c  
 	
 ${OBJECTDIR}/_ext/2108356922/BTCom.o: ../Common/BTCom.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/BTCom.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/BTCom.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/BTCom.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/BTCom.o.d" -o ${OBJECTDIR}/_ext/2108356922/BTCom.o ../Common/BTCom.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/BTCom.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/BTCom.o.d" -o ${OBJECTDIR}/_ext/2108356922/BTCom.o ../Common/BTCom.c  
+	
+${OBJECTDIR}/_ext/2108356922/BTComDecoder.o: ../Common/BTComDecoder.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/BTComDecoder.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/BTComDecoder.o.d" -o ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o ../Common/BTComDecoder.c  
 	
 ${OBJECTDIR}/_ext/2108356922/CircBuffer.o: ../Common/CircBuffer.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/CircBuffer.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d" -o ${OBJECTDIR}/_ext/2108356922/CircBuffer.o ../Common/CircBuffer.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d" -o ${OBJECTDIR}/_ext/2108356922/CircBuffer.o ../Common/CircBuffer.c  
+	
+${OBJECTDIR}/_ext/2108356922/CRC16.o: ../Common/CRC16.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/CRC16.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/CRC16.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/CRC16.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/CRC16.o.d" -o ${OBJECTDIR}/_ext/2108356922/CRC16.o ../Common/CRC16.c  
+	
+${OBJECTDIR}/_ext/2108356922/LZSS.o: ../Common/LZSS.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/LZSS.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/LZSS.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/LZSS.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/LZSS.o.d" -o ${OBJECTDIR}/_ext/2108356922/LZSS.o ../Common/LZSS.c  
 	
 ${OBJECTDIR}/_ext/2108356922/Delay.o: ../Common/Delay.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/Delay.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/Delay.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/Delay.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/Delay.o.d" -o ${OBJECTDIR}/_ext/2108356922/Delay.o ../Common/Delay.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/Delay.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/Delay.o.d" -o ${OBJECTDIR}/_ext/2108356922/Delay.o ../Common/Delay.c  
 	
 ${OBJECTDIR}/_ext/2108356922/M24512.o: ../Common/M24512.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/M24512.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/M24512.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/M24512.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/M24512.o.d" -o ${OBJECTDIR}/_ext/2108356922/M24512.o ../Common/M24512.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/M24512.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/M24512.o.d" -o ${OBJECTDIR}/_ext/2108356922/M24512.o ../Common/M24512.c  
 	
 ${OBJECTDIR}/_ext/2108356922/NVMem.o: ../Common/NVMem.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/NVMem.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/NVMem.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/NVMem.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/NVMem.o.d" -o ${OBJECTDIR}/_ext/2108356922/NVMem.o ../Common/NVMem.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/NVMem.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/NVMem.o.d" -o ${OBJECTDIR}/_ext/2108356922/NVMem.o ../Common/NVMem.c  
 	
 ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o: ../Common/TaskScheduler.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d" -o ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o ../Common/TaskScheduler.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d" -o ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o ../Common/TaskScheduler.c  
+	
+${OBJECTDIR}/_ext/2108356922/SoftTimer.o: ../Common/SoftTimer.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/SoftTimer.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/SoftTimer.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/SoftTimer.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/SoftTimer.o.d" -o ${OBJECTDIR}/_ext/2108356922/SoftTimer.o ../Common/SoftTimer.c  
+	
+${OBJECTDIR}/_ext/2108356922/UartDMA.o: ../Common/UartDMA.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/UartDMA.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/UartDMA.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/UartDMA.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/UartDMA.o.d" -o ${OBJECTDIR}/_ext/2108356922/UartDMA.o ../Common/UartDMA.c  
 	
 ${OBJECTDIR}/_ext/2108356922/uart1.o: ../Common/uart1.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/uart1.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/uart1.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/uart1.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/uart1.o.d" -o ${OBJECTDIR}/_ext/2108356922/uart1.o ../Common/uart1.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/uart1.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/uart1.o.d" -o ${OBJECTDIR}/_ext/2108356922/uart1.o ../Common/uart1.c  
 	
 ${OBJECTDIR}/_ext/2108356922/uart2.o: ../Common/uart2.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/uart2.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/uart2.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/uart2.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/uart2.o.d" -o ${OBJECTDIR}/_ext/2108356922/uart2.o ../Common/uart2.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/uart2.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/uart2.o.d" -o ${OBJECTDIR}/_ext/2108356922/uart2.o ../Common/uart2.c  
 	
 else
 ${OBJECTDIR}/AutoDuctBootloader.o: AutoDuctBootloader.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/AutoDuctBootloader.o.d 
 	@${RM} ${OBJECTDIR}/AutoDuctBootloader.o 
-	@${FIXDEPS} "${OBJECTDIR}/AutoDuctBootloader.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/AutoDuctBootloader.o.d" -o ${OBJECTDIR}/AutoDuctBootloader.o AutoDuctBootloader.c  
+	@${FIXDEPS} "${OBJECTDIR}/AutoDuctBootloader.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/AutoDuctBootloader.o.d" -o ${OBJECTDIR}/AutoDuctBootloader.o AutoDuctBootloader.c  
 	
 ${OBJECTDIR}/BTComCallbacksBootloader.o: BTComCallbacksBootloader.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/BTComCallbacksBootloader.o.d 
 	@${RM} ${OBJECTDIR}/BTComCallbacksBootloader.o 
-	@${FIXDEPS} "${OBJECTDIR}/BTComCallbacksBootloader.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/BTComCallbacksBootloader.o.d" -o ${OBJECTDIR}/BTComCallbacksBootloader.o BTComCallbacksBootloader.c  
+	@${FIXDEPS} "${OBJECTDIR}/BTComCallbacksBootloader.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/BTComCallbacksBootloader.o.d" -o ${OBJECTDIR}/BTComCallbacksBootloader.o BTComCallbacksBootloader.c  
 	
 ${OBJECTDIR}/_ext/2108356922/BTCom.o: ../Common/BTCom.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/BTCom.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/BTCom.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/BTCom.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/BTCom.o.d" -o ${OBJECTDIR}/_ext/2108356922/BTCom.o ../Common/BTCom.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/BTCom.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/BTCom.o.d" -o ${OBJECTDIR}/_ext/2108356922/BTCom.o ../Common/BTCom.c  
+	
+${OBJECTDIR}/_ext/2108356922/BTComDecoder.o: ../Common/BTComDecoder.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/BTComDecoder.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/BTComDecoder.o.d" -o ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o ../Common/BTComDecoder.c  
 	
 ${OBJECTDIR}/_ext/2108356922/CircBuffer.o: ../Common/CircBuffer.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/CircBuffer.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d" -o ${OBJECTDIR}/_ext/2108356922/CircBuffer.o ../Common/CircBuffer.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d" -o ${OBJECTDIR}/_ext/2108356922/CircBuffer.o ../Common/CircBuffer.c  
+	
+${OBJECTDIR}/_ext/2108356922/CRC16.o: ../Common/CRC16.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/CRC16.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/CRC16.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/CRC16.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/CRC16.o.d" -o ${OBJECTDIR}/_ext/2108356922/CRC16.o ../Common/CRC16.c  
+	
+${OBJECTDIR}/_ext/2108356922/LZSS.o: ../Common/LZSS.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/LZSS.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/LZSS.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/LZSS.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/LZSS.o.d" -o ${OBJECTDIR}/_ext/2108356922/LZSS.o ../Common/LZSS.c  
 	
 ${OBJECTDIR}/_ext/2108356922/Delay.o: ../Common/Delay.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/Delay.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/Delay.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/Delay.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/Delay.o.d" -o ${OBJECTDIR}/_ext/2108356922/Delay.o ../Common/Delay.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/Delay.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/Delay.o.d" -o ${OBJECTDIR}/_ext/2108356922/Delay.o ../Common/Delay.c  
 	
 ${OBJECTDIR}/_ext/2108356922/M24512.o: ../Common/M24512.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/M24512.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/M24512.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/M24512.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/M24512.o.d" -o ${OBJECTDIR}/_ext/2108356922/M24512.o ../Common/M24512.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/M24512.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/M24512.o.d" -o ${OBJECTDIR}/_ext/2108356922/M24512.o ../Common/M24512.c  
 	
 ${OBJECTDIR}/_ext/2108356922/NVMem.o: ../Common/NVMem.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/NVMem.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/NVMem.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/NVMem.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/NVMem.o.d" -o ${OBJECTDIR}/_ext/2108356922/NVMem.o ../Common/NVMem.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/NVMem.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/NVMem.o.d" -o ${OBJECTDIR}/_ext/2108356922/NVMem.o ../Common/NVMem.c  
 	
 ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o: ../Common/TaskScheduler.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d" -o ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o ../Common/TaskScheduler.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d" -o ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o ../Common/TaskScheduler.c  
+	
+${OBJECTDIR}/_ext/2108356922/SoftTimer.o: ../Common/SoftTimer.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/SoftTimer.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/SoftTimer.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/SoftTimer.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/SoftTimer.o.d" -o ${OBJECTDIR}/_ext/2108356922/SoftTimer.o ../Common/SoftTimer.c  
+	
+${OBJECTDIR}/_ext/2108356922/UartDMA.o: ../Common/UartDMA.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/UartDMA.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/UartDMA.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/UartDMA.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/UartDMA.o.d" -o ${OBJECTDIR}/_ext/2108356922/UartDMA.o ../Common/UartDMA.c  
 	
 ${OBJECTDIR}/_ext/2108356922/uart1.o: ../Common/uart1.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/uart1.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/uart1.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/uart1.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/uart1.o.d" -o ${OBJECTDIR}/_ext/2108356922/uart1.o ../Common/uart1.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/uart1.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/uart1.o.d" -o ${OBJECTDIR}/_ext/2108356922/uart1.o ../Common/uart1.c  
 	
 ${OBJECTDIR}/_ext/2108356922/uart2.o: ../Common/uart2.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/uart2.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/uart2.o 
-	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/uart2.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/uart2.o.d" -o ${OBJECTDIR}/_ext/2108356922/uart2.o ../Common/uart2.c  
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/uart2.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -ffunction-sections -Os -D_BOOTLOADER_ -MMD -MF "${OBJECTDIR}/_ext/2108356922/uart2.o.d" -o ${OBJECTDIR}/_ext/2108356922/uart2.o ../Common/uart2.c  
 	
 endif
 
@@ -235,11 +295,11 @@ endif
 ifeq ($(TYPE_IMAGE), DEBUG_RUN)
 dist/${CND_CONF}/${IMAGE_TYPE}/AutoDuctBootloader.X.${IMAGE_TYPE}.${OUTPUT_SUFFIX}: ${OBJECTFILES}  nbproject/Makefile-${CND_CONF}.mk    Linker\ Scripts/btl_32MX150F128B_generic_autoduct.ld
 	@${MKDIR} dist/${CND_CONF}/${IMAGE_TYPE} 
-	${MP_CC} $(MP_EXTRA_LD_PRE)  -mdebugger -D__MPLAB_DEBUGGER_ICD3=1 -mprocessor=$(MP_PROCESSOR_OPTION)  -o dist/${CND_CONF}/${IMAGE_TYPE}/AutoDuctBootloader.X.${IMAGE_TYPE}.${OUTPUT_SUFFIX} ${OBJECTFILES_QUOTED_IF_SPACED}       -Wl,--defsym=__MPLAB_BUILD=1$(MP_EXTRA_LD_POST)$(MP_LINKER_FILE_OPTION),--defsym=__ICD2RAM=1,--defsym=__MPLAB_DEBUG=1,--defsym=__DEBUG=1,--defsym=__MPLAB_DEBUGGER_ICD3=1,-Map="${DISTDIR}/${PROJECTNAME}.${IMAGE_TYPE}.map",--report-mem 
+	${MP_CC} $(MP_EXTRA_LD_PRE)  -mdebugger -D__MPLAB_DEBUGGER_ICD3=1 -mprocessor=$(MP_PROCESSOR_OPTION)  -o dist/${CND_CONF}/${IMAGE_TYPE}/AutoDuctBootloader.X.${IMAGE_TYPE}.${OUTPUT_SUFFIX} ${OBJECTFILES_QUOTED_IF_SPACED}       -Wl,--defsym=__MPLAB_BUILD=1$(MP_EXTRA_LD_POST)$(MP_LINKER_FILE_OPTION),--defsym=__ICD2RAM=1,--defsym=__MPLAB_DEBUG=1,--defsym=__DEBUG=1,--defsym=__MPLAB_DEBUGGER_ICD3=1,-Map="${DISTDIR}/${PROJECTNAME}.${IMAGE_TYPE}.map",--gc-sections,--report-mem 
 else
 dist/${CND_CONF}/${IMAGE_TYPE}/AutoDuctBootloader.X.${IMAGE_TYPE}.${OUTPUT_SUFFIX}: ${OBJECTFILES}  nbproject/Makefile-${CND_CONF}.mk   Linker\ Scripts/btl_32MX150F128B_generic_autoduct.ld
 	@${MKDIR} dist/${CND_CONF}/${IMAGE_TYPE} 
-	${MP_CC} $(MP_EXTRA_LD_PRE)  -mprocessor=$(MP_PROCESSOR_OPTION)  -o dist/${CND_CONF}/${IMAGE_TYPE}/AutoDuctBootloader.X.${IMAGE_TYPE}.${DEBUGGABLE_SUFFIX} ${OBJECTFILES_QUOTED_IF_SPACED}       -Wl,--defsym=__MPLAB_BUILD=1$(MP_EXTRA_LD_POST)$(MP_LINKER_FILE_OPTION),-Map="${DISTDIR}/${PROJECTNAME}.${IMAGE_TYPE}.map",--report-mem
+	${MP_CC} $(MP_EXTRA_LD_PRE)  -mprocessor=$(MP_PROCESSOR_OPTION)  -o dist/${CND_CONF}/${IMAGE_TYPE}/AutoDuctBootloader.X.${IMAGE_TYPE}.${DEBUGGABLE_SUFFIX} ${OBJECTFILES_QUOTED_IF_SPACED}       -Wl,--defsym=__MPLAB_BUILD=1$(MP_EXTRA_LD_POST)$(MP_LINKER_FILE_OPTION),-Map="${DISTDIR}/${PROJECTNAME}.${IMAGE_TYPE}.map",--gc-sections,--report-mem
 	${MP_CC_DIR}\\pic32-bin2hex dist/${CND_CONF}/${IMAGE_TYPE}/AutoDuctBootloader.X.${IMAGE_TYPE}.${DEBUGGABLE_SUFFIX}  
 endif
 
@@ -4,6 +4,8 @@
 #include "HardwareProfile.h"
 #include "uart2.h"
 #include "uart1.h"
+#include "UartDMA.h"
+#include "Log.h"
 #include "circbuffer.h"
 #include <time.h>
 #include "userConsole.h"
@@ -20,6 +22,7 @@
 #include "BTComCallbacksApp.h"
 #include "BootLoader.h"
 #include "RTC_RV3129.h"
+#include "Config.h"
 
 
 
@@ -119,6 +122,10 @@ static void InitializeBoard(void);
 //      Uart1TxStringPolled(" at 0x");
 //      Uart1TxUint32HexPolled(_excep_addr);
 //      Uart1TxStringPolled("\r\n");
+
+      // interrupts are off here, send the message by polling
+      UartDMA_Flush(UARTDMA_UART2);
+
       while (1) 
       {
           asm("nop");
@@ -129,8 +136,16 @@ static void InitializeBoard(void);
   }
 
 
+// scheduler idle time: queued BLE requests, log output
+BYTE Main_IdleTask()
+{
+    BYTE busy = BTCom_IdleTask();
+
+    return Log_Task() | busy;
+}
+
 // Handle communication via BLE interface and debug console
-void UserInput_Task(void *pvParameters, BYTE *skiprate)
+void UserInput_Task(void *pvParameters, DWORD *skiprate)
 {
     BTCom_Task();
     UserConsole_Task();
@@ -229,6 +244,9 @@ int main(void)
     UserConsole_Init();
     // initialize task scheduler
     Scheduler_Init();    
+    // initialize logging, records are printed in the scheduler idle time
+    Log_Init();
+    Scheduler_SetIdleTask(Main_IdleTask);
     // initialize LED fading controller
     LEDFade_Init();
     // initialize shutter motion controller
@@ -239,7 +257,7 @@ int main(void)
     DeviceControl_Init();
     // initialize protocol handler for BLE communication
     BTCom_Init();
-    BTCom_SetupCallbacks();
+    BTCom_SetLinkCallback(DeviceControl_LinkChanged);
     // initialize SHT31 humidity/temperature sensor
     SHT3X_Init(0x44);
     // initialize configuration storage EEPROM
@@ -248,6 +266,8 @@ int main(void)
     rv3129_init();
     // load device config from EEPROM
     LoadConfig();
+    // switch BLE module UART to the negotiated rate
+    Bootcode_SetupBLEBaudrate(0);
     // initialize time keeper module
     TimeKeeper_Init();        
     // setup LED fading engine
@@ -262,8 +282,16 @@ int main(void)
     Scheduler_AddTask(1, LEDFade_Task, NULL, 1, 0);
     Scheduler_AddTask(2, FanControl_Task, NULL, 1, 0);    
     Scheduler_AddTask(3, UserInput_Task, NULL, 1, 0);        
-    Scheduler_AddTask(4, ValveMotionControl_Task, NULL, 1, 0);        
-    Scheduler_AddTask(5, TimeKeeper_Task, NULL, 1, 0);           
+    Scheduler_AddTask(4, ValveMotionControl_Task, NULL, SCHEDULER_PRIO_REALTIME, 0);        
+    Scheduler_AddPeriodicTask(5, TimeKeeper_Task, NULL, 1, TIMEKEEPER_PERIOD);
+    Scheduler_AddTask(6, Config_Task, NULL, 1, 0);           
+    Scheduler_AddTask(7, DeviceControl_SHT31_Task, NULL, 1, 0);
+
+    // ticks a task may be deferred under load before a deadline miss is counted
+    Scheduler_SetTaskDeadline(1, 2);        // LED fading
+    Scheduler_SetTaskDeadline(3, 2);        // console and BLE input
+    Scheduler_SetTaskDeadline(5, 5);        // time keeping
+    Scheduler_SetTaskDeadline(6, 25);       // background config save
 
     DEBUG_puts("\n\r\n\rBoard Init complete.\n\r\n\r");        
  
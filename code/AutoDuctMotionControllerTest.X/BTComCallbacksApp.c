@@ -5,6 +5,9 @@
 //#include "Config.h"
 #include "DeviceControl.h"
 #include "BootLoader.h"
+#include "TaskScheduler.h"
+#include "Config.h"
+#include <string.h>
 
 
 // command table
@@ -19,6 +22,13 @@
 #define CMD_SCROLLTEXTTEST  0x08        // new for Wordclock
 #define CMD_CLOCKSYNC       0x09        // new for Wordclock
 #define CMD_GETCLOCK        0x0A        
+#define CMD_PROFILE         0x0B        // read task execution time profile
+#define CMD_SUBSCRIBE       0x0C        // subscribe to status change notifications (CMD_STATUS_NOTIFY)
+#define CMD_CFGINFO         0x0E        // read size and content hash of all config fragments
+#define CMD_READCFGPART     0x0F        // read part of a config fragment
+#define CMD_WRITECFGPART    0x10        // update part of a config fragment
+#define CMD_MEMDUMP         0x11        // stream RAM / flash contents
+#define CMD_CFGDUMP         0x12        // stream all config fragments
 #define CMD_DEV_PROGRAM             0xF0
 #define CMD_DEV_RESET               0xF1
 #define CMD_DEV_TESTMODE            0xFB
@@ -35,7 +45,7 @@ void Bootcode_setMagicNumber(DWORD magic);
 
 
 
-void BTCom_defaultCallback(BYTE *buf_in, BYTE *buf_out, BYTE* len)
+void BTCom_defaultCallback(BYTE *buf_in, BYTE *buf_out, WORD *len)
 {
     //responseBytes = *len-1;  // echo back entire data packet (last data byte is checksum)        
     *len = *len-1;
@@ -102,7 +112,7 @@ void SendFWStringBT(BYTE *inbuf, BYTE *outbuf, WORD *len)
 }
 
 
-void cmd_manvent_callback(BYTE *buf_in, BYTE *outbuf, BYTE *responseBytes)
+void cmd_manvent_callback(BYTE *buf_in, BYTE *outbuf, WORD *responseBytes)
 {
     // CMD              buf_in[0]
 
@@ -119,7 +129,7 @@ void cmd_manvent_callback(BYTE *buf_in, BYTE *outbuf, BYTE *responseBytes)
 }
 
 
-void cmd_setmode_callback(BYTE *buf_in, BYTE *outbuf, BYTE *responseBytes)
+void cmd_setmode_callback(BYTE *buf_in, BYTE *outbuf, WORD *responseBytes)
 {
     // CMD              buf_in[0]
     // mode             buf_in[1]
@@ -130,7 +140,7 @@ void cmd_setmode_callback(BYTE *buf_in, BYTE *outbuf, BYTE *responseBytes)
 }
 
         
-void cmd_readconfig_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+void cmd_readconfig_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {
             
     // buf_in[0] = CMD
@@ -140,21 +150,109 @@ void cmd_readconfig_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
 }
 
 
-void cmd_updateconfig_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+void cmd_updateconfig_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {
-    Config_UpdateFragment(buf_in[1], &buf_in[2]);
+    // buf_in[0] = CMD
+    // buf_in[1] = ID
+    // buf_in[2..n] = fragment data
+
+    // *responseBytes = request length + 1
+    if(Config_UpdateFragment(buf_in[1], &buf_in[2], *responseBytes - 3) != CFG_RES_OK)
+    {
+        DEBUG_puts("UPDATECONFIG: invalid fragment or length\n\r");
+    }
 
     *responseBytes = 1;    // set response length to 1 byte  (just echo command)
 }    
 
 
-void cmd_status_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+void cmd_cfginfo_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
+{
+    // buf_out[1] = number of fragments
+    // per fragment: size (2 bytes), content hash (2 bytes)
+
+    BYTE *bptr = &buf_out[2];
+    WORD hash;
+    BYTE i;
+
+    buf_out[1] = CFG_NUM_FRAGMENTS;
+
+    for(i=0; i<CFG_NUM_FRAGMENTS; i++)
+    {
+        hash = Config_FragmentHash(i);
+        *bptr++ = CFG_fragment_size[i] >> 8;
+        *bptr++ = CFG_fragment_size[i] & 0xFF;
+        *bptr++ = hash >> 8;
+        *bptr++ = hash & 0xFF;
+    }
+
+    *responseBytes = 2 + CFG_NUM_FRAGMENTS*4;
+}
+
+
+void cmd_readcfgpart_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
+{
+    // buf_in[0] = CMD
+    // buf_in[1] = ID
+    // buf_in[2] = offset
+    // buf_in[3] = length
+
+    // response: CMD, ID, result, hash (2 bytes), data
+    BYTE ID = buf_in[1];
+    BYTE offset = buf_in[2];
+    BYTE len = buf_in[3];
+    WORD hash;
+
+    buf_out[2] = Config_ReadFragmentPart(ID, offset, len, &buf_out[5]);
+    hash = Config_FragmentHash(ID);
+    buf_out[1] = ID;
+    buf_out[3] = hash >> 8;
+    buf_out[4] = hash & 0xFF;
+
+    *responseBytes = (buf_out[2] == CFG_RES_OK) ? 5 + len : 5;
+}
+
+
+void cmd_writecfgpart_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
+{
+    // buf_in[0] = CMD
+    // buf_in[1] = ID
+    // buf_in[2] = offset
+    // buf_in[3] = length
+    // buf_in[4..n] = data
+
+    // response: CMD, ID, result, new hash (2 bytes)
+    BYTE ID = buf_in[1];
+    BYTE res;
+    WORD hash;
+
+    // *responseBytes = request length + 1
+    if(buf_in[3] != *responseBytes - 5)
+    {
+        res = CFG_RES_INVALID_RANGE;
+    }
+    else
+    {
+        res = Config_WriteFragmentPart(ID, buf_in[2], buf_in[3], &buf_in[4]);
+    }
+
+    hash = Config_FragmentHash(ID);
+    buf_out[1] = ID;
+    buf_out[2] = res;
+    buf_out[3] = hash >> 8;
+    buf_out[4] = hash & 0xFF;
+
+    *responseBytes = 5;
+}
+
+
+void cmd_status_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {
     DeviceControl_StatusBTCom(buf_out, responseBytes);   
 }
 
 
-void cmd_clocksync_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+void cmd_clocksync_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {
 //                cmddata[1] = (byte)rnow.get(Calendar.HOUR_OF_DAY);
 //                cmddata[2] = (byte)rnow.get(Calendar.MINUTE);
@@ -172,7 +270,7 @@ void cmd_clocksync_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
 }
 
 
-void cmd_getclock_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+void cmd_getclock_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {
 //                cmddata[1] = (byte)rnow.get(Calendar.HOUR_OF_DAY);
 //                cmddata[2] = (byte)rnow.get(Calendar.MINUTE);
@@ -194,8 +292,204 @@ void cmd_getclock_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
 }
 
 
+#ifdef SCHEDULER_PROFILING
+
+void cmd_profile_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
+{
+    // buf_in[0] = CMD
+    // buf_in[1] = task ID, 0xFF clears all profiling results
+
+    TaskProfileStruct prof;
+    DWORD misses;
+    WORD maxlate;
+    DWORD_VAL dVal;
+    BYTE *bptr = &buf_out[2];
+    BYTE i;
+
+    buf_out[1] = buf_in[1];
+
+    if(buf_in[1] == 0xFF)
+    {
+        Scheduler_ResetProfile();
+        *responseBytes = 2;
+        return;
+    }
+
+    if(buf_in[1] >= SCHEDULER_MAX_NUM_TASKS)
+    {
+        *responseBytes = 2;     // invalid task, echo ID only
+        return;
+    }
+
+    Scheduler_GetProfile(buf_in[1], &prof);
+
+    // calls, min, max, mean, overruns (core timer counts, MSB first)
+    for(i=0; i<5; i++)
+    {
+        switch(i)
+        {
+            case 0: dVal.Val = prof.calls; break;
+            case 1: dVal.Val = prof.calls ? prof.min : 0; break;
+            case 2: dVal.Val = prof.max; break;
+            case 3: dVal.Val = prof.calls ? (DWORD)(prof.sum / prof.calls) : 0; break;
+            case 4: dVal.Val = prof.overruns; break;
+        }
+        *bptr++ = dVal.v[3];
+        *bptr++ = dVal.v[2];
+        *bptr++ = dVal.v[1];
+        *bptr++ = dVal.v[0];
+    }
+
+    // log2 histogram bins
+    for(i=0; i<SCHEDULER_PROFILE_HIST_BINS; i++)
+    {
+        *bptr++ = prof.hist[i] >> 8;
+        *bptr++ = prof.hist[i] & 0xFF;
+    }
+
+    // deadline misses and longest deferral in ticks
+    Scheduler_GetDeadlineStats(buf_in[1], &misses, &maxlate);
+    dVal.Val = misses;
+    *bptr++ = dVal.v[3];
+    *bptr++ = dVal.v[2];
+    *bptr++ = dVal.v[1];
+    *bptr++ = dVal.v[0];
+    *bptr++ = maxlate >> 8;
+    *bptr++ = maxlate & 0xFF;
+
+    *responseBytes = 2 + 5*4 + SCHEDULER_PROFILE_HIST_BINS*2 + 6;     // 60 bytes
+}
+
+#endif
+
+
+void cmd_subscribe_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
+{
+    // buf_in[0] = CMD
+    // buf_in[1..2] = status byte mask (bit n = CMD_STATUS response byte n), 0 = unsubscribe
+    // buf_in[3..4] = min. interval between notifications (ms)
+
+    WORD mask;
+
+    mask = DeviceControl_Subscribe(((WORD)buf_in[1] << 8) | buf_in[2], ((WORD)buf_in[3] << 8) | buf_in[4]);
+
+    // return accepted mask
+    buf_out[1] = mask >> 8;
+    buf_out[2] = mask & 0xFF;
+    *responseBytes = 3;
+}
+
+
+// readable memory regions (KSEG0/KSEG1 addresses)
+typedef struct
+{
+    DWORD start;
+    DWORD size;
+}MemRegionStruct;
+
+static const MemRegionStruct memregions[] =
+{
+    {0x80000000, 32*1024},      // RAM
+    {0xA0000000, 32*1024},
+    {0x9D000000, 128*1024},     // program flash
+    {0xBD000000, 128*1024},
+    {0x9FC00000, 3*1024},       // boot flash
+    {0xBFC00000, 3*1024},
+};
+
+static struct
+{
+    DWORD address;
+    DWORD size;
+}memdump;
+
+static WORD memdump_producer(void *ctx, DWORD offset, BYTE *buf, WORD max)
+{
+    if(offset >= memdump.size)
+        return 0;
+
+    if(memdump.size - offset < max)
+        max = memdump.size - offset;
+
+    memcpy(buf, (BYTE*)(memdump.address + offset), max);
+
+    return max;
+}
+
+void cmd_memdump_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
+{
+    // buf_in[0] = CMD
+    // buf_in[1..4] = start address
+    // buf_in[5..8] = size
+    // buf_in[9..15] = stream offset, crc, credits
+
+    DWORD address, size;
+    BYTE i;
+
+    address = ((DWORD)buf_in[1] << 24) | ((DWORD)buf_in[2] << 16) | ((DWORD)buf_in[3] << 8) | buf_in[4];
+    size = ((DWORD)buf_in[5] << 24) | ((DWORD)buf_in[6] << 16) | ((DWORD)buf_in[7] << 8) | buf_in[8];
+
+    buf_out[1] = 0x01;      // invalid memory range
+    *responseBytes = 2;
+
+    // reading outside of the memory regions causes a bus error exception
+    for(i=0; i<sizeof(memregions)/sizeof(MemRegionStruct); i++)
+    {
+        if(address >= memregions[i].start && size <= memregions[i].size &&
+           address - memregions[i].start <= memregions[i].size - size)
+        {
+            memdump.address = address;
+            memdump.size = size;
+            BTCom_StartStream(CMD_MEMDUMP, &buf_in[9], memdump_producer, NULL);
+            buf_out[1] = 0x00;      // OK, stream follows
+            break;
+        }
+    }
+}
+
+
+// config fragments in ascending ID order (reserved fragment skipped)
+static WORD cfgdump_producer(void *ctx, DWORD offset, BYTE *buf, WORD max)
+{
+    WORD n = 0, part;
+    BYTE ID;
+
+    for(ID=0; ID<CFG_NUM_FRAGMENTS && n < max; ID++)
+    {
+        if(ID == CFG_ID_RESERVED)
+            continue;
+
+        if(offset >= CFG_fragment_size[ID])
+        {
+            offset -= CFG_fragment_size[ID];
+            continue;
+        }
+
+        part = CFG_fragment_size[ID] - offset;
+        if(part > max - n)
+            part = max - n;
+
+        Config_ReadFragmentPart(ID, offset, part, &buf[n]);
+        n += part;
+        offset = 0;
+    }
+
+    return n;
+}
+
+void cmd_cfgdump_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
+{
+    // buf_in[0] = CMD
+    // buf_in[1..7] = stream offset, crc, credits
+
+    BTCom_StartStream(CMD_CFGDUMP, &buf_in[1], cfgdump_producer, NULL);
+
+    buf_out[1] = 0x00;      // OK, stream follows
+    *responseBytes = 2;
+}
+
             
-void cmd_dev_program_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+void cmd_dev_program_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {           
 
     // TODO:
@@ -241,7 +535,7 @@ void cmd_dev_program_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
 }            
 
 
-void cmd_dev_testmode_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+void cmd_dev_testmode_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {           
 
     
@@ -276,7 +570,7 @@ void cmd_dev_testmode_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
 
 
         
-void cmd_dev_reset_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
+void cmd_dev_reset_callback(BYTE *buf_in, BYTE *buf_out, WORD *responseBytes)
 {           
     
     // buf_in[0] = CMD
@@ -310,20 +604,37 @@ void cmd_dev_reset_callback(BYTE *buf_in, BYTE *buf_out, BYTE *responseBytes)
 }            
             
 
-void BTCom_SetupCallbacks()
+// command registry, sorted by command ID
+// (request/response lengths including the command byte)
+const CommandStruct BTCom_commands[] =
 {
-    BTCom_addCallback(CMD_RESERVED,     BTCom_defaultCallback);
-    BTCom_addCallback(CMD_MANVENT,      cmd_manvent_callback);   
-    BTCom_addCallback(CMD_SETMODE,      cmd_setmode_callback);   
-    BTCom_addCallback(CMD_STATUS,       cmd_status_callback);   
-    BTCom_addCallback(CMD_READCONFIG,   cmd_readconfig_callback); 
-    BTCom_addCallback(CMD_UPDATECONFIG, cmd_updateconfig_callback); 
-    BTCom_addCallback(CMD_FWREV,        SendFWStringBT); 
-    BTCom_addCallback(CMD_CLOCKSYNC,    cmd_clocksync_callback); 
-    BTCom_addCallback(CMD_GETCLOCK,     cmd_getclock_callback); 
-    BTCom_addCallback(CMD_DEV_PROGRAM,  cmd_dev_program_callback); 
-    BTCom_addCallback(CMD_DEV_ECHO,     BTCom_defaultCallback); 
-    BTCom_addCallback(CMD_DEV_RESET,    cmd_dev_reset_callback);  
-    BTCom_addCallback(CMD_DEV_TESTMODE, cmd_dev_testmode_callback);  
-}
+    //            command            callback                    request          response
+    BTCOM_COMMAND(CMD_RESERVED,      BTCom_defaultCallback,      1, BTCOM_LEN_ANY, BTCOM_LEN_ECHO),
+    BTCOM_COMMAND(CMD_MANVENT,       cmd_manvent_callback,       5, 5,             1),
+    BTCOM_COMMAND(CMD_SETMODE,       cmd_setmode_callback,       2, 2,             1),
+    BTCOM_COMMAND(CMD_STATUS,        cmd_status_callback,        1, 1,             DEVCTL_STATUS_LEN),
+    BTCOM_COMMAND(CMD_READCONFIG,    cmd_readconfig_callback,    2, 2,             CFG_FRAGMENT_SIZE_MAX + 2),
+    BTCOM_COMMAND(CMD_UPDATECONFIG,  cmd_updateconfig_callback,  2, BTCOM_LEN_ANY, 1),
+    BTCOM_COMMAND(CMD_FWREV,         SendFWStringBT,             1, 1,             13*4 + 1),
+    BTCOM_COMMAND(CMD_CLOCKSYNC,     cmd_clocksync_callback,     9, 9,             1),
+    BTCOM_COMMAND(CMD_GETCLOCK,      cmd_getclock_callback,      1, 1,             8),
+#ifdef SCHEDULER_PROFILING
+    BTCOM_COMMAND(CMD_PROFILE,       cmd_profile_callback,       2, 2,             2 + 5*4 + SCHEDULER_PROFILE_HIST_BINS*2 + 6),
+#endif
+    BTCOM_COMMAND(CMD_SUBSCRIBE,     cmd_subscribe_callback,     5, 5,             3),
+    BTCOM_COMMAND(CMD_CFGINFO,       cmd_cfginfo_callback,       1, 1,             2 + CFG_NUM_FRAGMENTS*4),
+    BTCOM_COMMAND(CMD_READCFGPART,   cmd_readcfgpart_callback,   4, 4,             5 + CFG_FRAGMENT_SIZE_MAX),
+    BTCOM_COMMAND(CMD_WRITECFGPART,  cmd_writecfgpart_callback,  4, 4 + CFG_FRAGMENT_SIZE_MAX, 5),
+    BTCOM_COMMAND(CMD_MEMDUMP,       cmd_memdump_callback,       9 + BTCOM_STREAM_PARAMS, 9 + BTCOM_STREAM_PARAMS, 2),
+    BTCOM_COMMAND(CMD_CFGDUMP,       cmd_cfgdump_callback,       1 + BTCOM_STREAM_PARAMS, 1 + BTCOM_STREAM_PARAMS, 2),
+    BTCOM_COMMAND(CMD_DEV_PROGRAM,   cmd_dev_program_callback,   6, BTCOM_LEN_ANY, 2),
+    BTCOM_COMMAND(CMD_DEV_RESET,     cmd_dev_reset_callback,     3, 3,             2),
+    BTCOM_COMMAND_DIAG,
+    BTCOM_COMMAND_STREAM,
+    BTCOM_COMMAND_BATCH,
+    BTCOM_COMMAND(CMD_DEV_TESTMODE,  cmd_dev_testmode_callback,  2, 2,             1),
+    BTCOM_COMMAND(CMD_DEV_ECHO,      BTCom_defaultCallback,      1, BTCOM_LEN_ANY, BTCOM_LEN_ECHO),
+};
+
+const WORD BTCom_commandCount = sizeof(BTCom_commands) / sizeof(BTCom_commands[0]);
 
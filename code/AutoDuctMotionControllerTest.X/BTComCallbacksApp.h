@@ -9,8 +9,5 @@
 #include "UART1.h"
 
 
-void BTCom_SetupCallbacks();
-
-
 #endif	/* BTCOMCALLBACKSAPP_H */
 
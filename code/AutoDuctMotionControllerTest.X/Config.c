@@ -4,6 +4,9 @@
 #include "BTCom.h"
 #include "TimeKeeper.h"
 #include "Bootloader.h"
+#include "uart1.h"
+#include "CRC16.h"
+#include <string.h>
 
 
 cfg_base                 CFGbase;
@@ -143,6 +146,64 @@ void SaveConfig_UdatesOnly()
 }
 
 
+// state of the background config save (Config_Task)
+static CoroutineStruct CFG_save_cr;
+static EEPROMWriteContext CFG_save_ctx;
+static BYTE CFG_save_request = 0, CFG_save_busy = 0;
+static BYTE CFG_save_ID, CFG_save_cnt;
+
+// request saving all updated config fragments in the background
+void Config_RequestSave()
+{
+    CFG_save_request = 1;
+}
+
+// yielding variant of SaveConfig_UdatesOnly(). the change flag is cleared
+// before writing, so an update during the write is saved next time
+static BYTE Config_SaveUpdates_cr()
+{
+    CR_BEGIN(&CFG_save_cr);
+
+    CFG_save_request = 0;
+    CFG_save_cnt = 0;
+
+    for(CFG_save_ID=0; CFG_save_ID<CFG_NUM_FRAGMENTS; CFG_save_ID++)
+    {
+        if(CFG_fragment_changed[CFG_save_ID])
+        {
+            CFG_fragment_changed[CFG_save_ID] = 0;
+            CFG_save_cnt++;
+
+            if(CFG_save_ID != CFG_ID_RESERVED)
+            {
+                EEPROM_write_start(&CFG_save_ctx, CFG_fragment_address[CFG_save_ID],
+                                   (BYTE*)CFG_fragment_ptr[CFG_save_ID], CFG_fragment_size[CFG_save_ID]);
+                CR_WAIT_CHILD(&CFG_save_cr, EEPROM_write_cr(&CFG_save_ctx));
+            }
+        }
+    }
+
+    if(CFG_save_cnt)
+        DEBUG_puts("\n\rConfig Updates Saved.");
+
+    CR_END(&CFG_save_cr);
+}
+
+// background config save task: runs every tick while saving, idles otherwise
+void Config_Task(void *pvParameters, DWORD *skiprate)
+{
+    if(CFG_save_busy || CFG_save_request)
+    {
+        CFG_save_busy = (Config_SaveUpdates_cr() == CR_WAITING);
+        *skiprate = 1;
+    }
+    else
+    {
+        *skiprate = CONFIG_TASK_IDLE_SKIPRATE;
+    }
+}
+
+
 // load entire config set
 void LoadConfig()
 {
@@ -235,23 +296,56 @@ void DumpConfig()
 }
 
 
-// copy data from buffer into selected Config Fragment
-void Config_UpdateFragment(BYTE ID, BYTE *data)
+// copy data from buffer into selected Config Fragment (<len> bytes received)
+BYTE Config_UpdateFragment(BYTE ID, BYTE *data, WORD len)
 {
-    BYTE j;
-    BYTE *ptr;
-    
-    if(ID >= CFG_NUM_FRAGMENTS)
-        return;
-    
-    ptr = CFG_fragment_ptr[ID];
-    for(j=0; j<CFG_fragment_size[ID]; j++)
-    {
-        *ptr++ = *data++;
-    }
-    
-    CFG_fragment_changed[ID] = 1;    
+    if(ID >= CFG_NUM_FRAGMENTS || ID == CFG_ID_RESERVED)
+        return CFG_RES_INVALID_ID;
     
+    if(len < CFG_fragment_size[ID])
+        return CFG_RES_INVALID_RANGE;
+
+    return Config_WriteFragmentPart(ID, 0, CFG_fragment_size[ID], data);
+}
+
+// copy <len> bytes at <offset> of a config fragment into outbuf
+BYTE Config_ReadFragmentPart(BYTE ID, BYTE offset, BYTE len, BYTE *outbuf)
+{
+    if(ID >= CFG_NUM_FRAGMENTS || ID == CFG_ID_RESERVED)
+        return CFG_RES_INVALID_ID;
+
+    if((WORD)offset + len > CFG_fragment_size[ID])
+        return CFG_RES_INVALID_RANGE;
+
+    memcpy(outbuf, CFG_fragment_ptr[ID] + offset, len);
+
+    return CFG_RES_OK;
+}
+
+// update <len> bytes at <offset> of a config fragment, saved by Config_Task
+BYTE Config_WriteFragmentPart(BYTE ID, BYTE offset, BYTE len, BYTE *data)
+{
+    if(ID >= CFG_NUM_FRAGMENTS || ID == CFG_ID_RESERVED)
+        return CFG_RES_INVALID_ID;
+
+    if((WORD)offset + len > CFG_fragment_size[ID])
+        return CFG_RES_INVALID_RANGE;
+
+    memcpy((BYTE*)CFG_fragment_ptr[ID] + offset, data, len);
+
+    CFG_fragment_changed[ID] = 1;
+
+    return CFG_RES_OK;
+}
+
+// content hash (CRC16) of a config fragment, lets the app skip reading
+// fragments it has cached. 0 for unknown or reserved fragments
+WORD Config_FragmentHash(BYTE ID)
+{
+    if(ID >= CFG_NUM_FRAGMENTS || ID == CFG_ID_RESERVED)
+        return 0;
+
+    return CRC16_Update(CRC16_INIT, (BYTE*)CFG_fragment_ptr[ID], CFG_fragment_size[ID]);
 }
 
 // set modified flag for specified config fragment
@@ -264,7 +358,7 @@ void Config_NotifyChanged(BYTE ID)
 }
 
 // copy specified config fragment into BLE protocol response buffer
-void ConfigBlueToothOutput(BYTE ID, BYTE *outbuf, BYTE *len)
+void ConfigBlueToothOutput(BYTE ID, BYTE *outbuf, WORD *len)
 {
     BYTE *bptr = &outbuf[1];
     BYTE *ptr;
@@ -307,6 +401,27 @@ void Bootcode_setMagicNumber(DWORD magic)
     cfg_bootcode.magicnumber = magic;
 }
 
+// set up the HM-17 UART rate. the bootloader negotiates it on power-up, so
+// the stored rate is used unless <negotiate> is set or no rate is stored
+void Bootcode_SetupBLEBaudrate(BYTE negotiate)
+{
+    DWORD baud;
+
+    LoadBootcodeConfig();
+
+    if(!negotiate && UART1_HM17UseBaudrate(cfg_bootcode.blebaud))
+    {
+        return;
+    }
+
+    baud = UART1_HM17Negotiate(cfg_bootcode.blebaud);
+    if(baud != 0 && baud != cfg_bootcode.blebaud)
+    {
+        cfg_bootcode.blebaud = baud;
+        SaveBootcodeConfig();
+    }
+}
+
 
 // read bootloader firmware version string
 BYTE getBootcodeVersionString(char *bcstring)
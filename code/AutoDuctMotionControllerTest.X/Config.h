@@ -17,6 +17,8 @@
 #define CONFIG_SIGNATURE        0xF007
 
 #define CFG_NUM_FRAGMENTS       3
+
+#define CONFIG_TASK_IDLE_SKIPRATE   25      // check for save requests every 100 ms
 // Configuration Fragment IDs
 
 #define CFG_ID_BASE             0
@@ -24,6 +26,13 @@
 
 #define CFG_ID_RESERVED         2
 
+#define CFG_FRAGMENT_SIZE_MAX   125     // largest readable fragment (CFG_VENT_SCHED)
+
+// partial fragment access result codes
+#define CFG_RES_OK              0x00
+#define CFG_RES_INVALID_ID      0x01    // unknown or reserved fragment
+#define CFG_RES_INVALID_RANGE   0x02    // offset/length outside of fragment
+
 
 #pragma pack(push,1)
 typedef struct cfg_base_TD
@@ -71,16 +80,22 @@ const WORD CFG_fragment_address[CFG_NUM_FRAGMENTS];
 void ConfigFactoryReset();
 void SaveConfig();
 void SaveConfig_UdatesOnly();
+void Config_RequestSave();
+void Config_Task(void *pvParameters, DWORD *skiprate);
 void LoadConfig();
-void ConfigBlueToothOutput(BYTE ID, BYTE *outbuf, BYTE *len);
+void ConfigBlueToothOutput(BYTE ID, BYTE *outbuf, WORD *len);
 void DumpConfig();
 
-void Config_UpdateFragment(BYTE ID, BYTE *data);
+BYTE Config_UpdateFragment(BYTE ID, BYTE *data, WORD len);
 void Config_NotifyChanged(BYTE ID);
+BYTE Config_ReadFragmentPart(BYTE ID, BYTE offset, BYTE len, BYTE *outbuf);
+BYTE Config_WriteFragmentPart(BYTE ID, BYTE offset, BYTE len, BYTE *data);
+WORD Config_FragmentHash(BYTE ID);
 
 void SaveBootcodeConfig();
 void LoadBootcodeConfig();
 void Bootcode_setMagicNumber(DWORD magic);
+void Bootcode_SetupBLEBaudrate(BYTE negotiate);
 BYTE getBootcodeVersionString(char *bcstring);
 
 
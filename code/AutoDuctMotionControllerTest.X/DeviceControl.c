@@ -9,6 +9,11 @@
 #include "FanControl.h"
 #include "LEDFade.h"
 #include "sht3x.h"
+#include "Coroutine.h"
+#include "SoftTimer.h"
+#include "Log.h"
+#include "BTCom.h"
+#include <string.h>
 
 
 
@@ -34,16 +39,22 @@ typedef struct DeviceCTL_Struct
     
     BYTE fanmode_manual;
 
-	WORD delaycnt;
+	SoftTimerStruct timer;          // fan PWM input poll timer
     
     
+    CoroutineStruct SHT31_cr;
     BYTE SHT31_state;
-    WORD SHT31_delaycnt;
     WORD SHT31_errorcnt;
     DWORD SHT31_serial;     // serial number of SHT31
     float SHT31_hum;
     float SHT31_temp;
     
+    WORD notifyMask;                // subscribed status bytes (bit n = byte n)
+    WORD notifyInterval;            // min. time between notifications (ms)
+    SoftTimerStruct notifyTimer;
+    BYTE notifyValid;               // notifyLast was sent
+    BYTE notifyLast[DEVCTL_STATUS_LEN];
+    
     // FanCTLSequenceData Sequence;
 }DeviceCTLData;	
 
@@ -66,152 +77,119 @@ void DeviceControl_Init()
     
     DevCTL.state = 0;   // uninitialized
     
-    DevCTL.delaycnt = 0;
+    SoftTimer_Stop(&DevCTL.timer);
     
+    CR_INIT(&DevCTL.SHT31_cr);
     DevCTL.SHT31_state = SHT31_UNINITIALIZED;
     DevCTL.SHT31_serial = 0xFFFFFFFF;
-    DevCTL.SHT31_delaycnt = 0;
     DevCTL.SHT31_hum = 0.0f;
     DevCTL.SHT31_temp = 0.0f;
     DevCTL.SHT31_errorcnt = 0;
+
+    DevCTL.notifyMask = 0;
+    SoftTimer_Stop(&DevCTL.notifyTimer);
 }
 
-// state machine for temperature/humidity measurement
-void DeviceControl_SHT31_StateMachine()
+// temperature/humidity measurement coroutine, run by DeviceControl_SHT31_Task.
+// every sensor transaction runs in its own tick, waiting times are task
+// skiprates, so the scheduler does not call the task in between
+static BYTE DeviceControl_SHT31_StateMachine(DWORD *skiprate)
 {
-    DWORD serialNumber;
     regStatus status;
     etError error;
 
-    float humidity, temperature; 
-    
-    switch(DevCTL.SHT31_state)
+    CR_BEGIN(&DevCTL.SHT31_cr);
+
+    // initialization: reset sensor, read serial number and status, start first measurement
+    while(DevCTL.SHT31_state == SHT31_UNINITIALIZED)
     {
-        case SHT31_UNINITIALIZED:
-            
-            if(DevCTL.SHT31_delaycnt == 0)
-            {
-                // reset SHT31 into known state
-                SHT3X_SoftReset();
+        // reset SHT31 into known state
+        SHT3X_StartSoftReset();
+        CR_SLEEP(&DevCTL.SHT31_cr, skiprate, SHT31_RESET_DELAY);
 
-                // read serial / part number
-                error = SHT3x_ReadSerialNumber(&DevCTL.SHT31_serial);    
+        // read serial / part number
+        SHT3x_ReadSerialNumber(&DevCTL.SHT31_serial);    
+        CR_YIELD(&DevCTL.SHT31_cr);
 
-//                sprintf(txt,"\n\rSHT31 Serial: %X, error: %X", DevCTL.SHT31_serial, error);
-//                DEBUG_puts(txt); 
+        // read status
+        if(SHT3X_ReadStatus(&status.u16) == NO_ERROR)
+        {
+            CR_YIELD(&DevCTL.SHT31_cr);
 
-                // read status
-                error = SHT3X_ReadStatus(&status.u16);    
-//                sprintf(txt,"\n\rSHT31 Status: %X, error: %X", status.u16, error);
-//                DEBUG_puts(txt);        
-                
-                if(error == NO_ERROR)
-                {
-                    // start Measurement
-                    error = SHT3X_StartMeasurement_Polling(REPEATAB_HIGH);
-                    
-                    if(error == NO_ERROR)
-                    {
-                        DevCTL.SHT31_state = SHT31_MEASURING;
-                        DevCTL.SHT31_delaycnt = SHT31_MEASURE_DELAY;
-                        
-                        DevCTL.SHT31_errorcnt = 0;
-                    }
-                    else
-                    {
-                        // wait a couple of seconds and try to initialize again
-                        DevCTL.SHT31_delaycnt = SHT31_MEASURE_DELAY;
-                        
-                        sprintf(txt,"\n\r(A) SHT31 error: %X, cnt: %d", error, DevCTL.SHT31_errorcnt);
-                        DEBUG_puts(txt);                        
-                        
-                        DevCTL.SHT31_errorcnt++;
-                        if(DevCTL.SHT31_errorcnt == SHT31_TIMEOUT_CNT)
-                        {
-                            // wait and try again
-                            DevCTL.SHT31_delaycnt = SHT31_MEASURE_INTERVAL;                    
-                        }                        
-                    }
-                }
-                else
-                {
-                    // wait a couple of seconds and try to initialize again
-                    DevCTL.SHT31_delaycnt = SHT31_MEASURE_DELAY;
-                }
-                
+            // start Measurement
+            error = SHT3X_StartMeasurement_Polling(REPEATAB_HIGH);
+
+            if(error == NO_ERROR)
+            {
+                DevCTL.SHT31_state = SHT31_MEASURING;
+                DevCTL.SHT31_errorcnt = 0;
             }
             else
-                DevCTL.SHT31_delaycnt--;
-            
-            
-        break;
-        case SHT31_MEASURING:
-            
-            if(DevCTL.SHT31_delaycnt == 0)
             {
-                error = SHT3X_ReadTempAndHumi_Polling(&DevCTL.SHT31_temp, &DevCTL.SHT31_hum); 
-                
-                if(error == NO_ERROR)
-                {
-                    sprintf(txt,"\n\rtemp: %3.2f, humidity: %3.2f", DevCTL.SHT31_temp, DevCTL.SHT31_hum);
-                    DEBUG_puts(txt);       
-                    
-                    DevCTL.SHT31_delaycnt = SHT31_MEASURE_INTERVAL;
-                    DevCTL.SHT31_state = SHT31_WAITING;
-                    
-                    DevCTL.SHT31_errorcnt = 0;
-                }
-                else
-                {
-                    // wait a couple of seconds and try again
-                    DevCTL.SHT31_delaycnt = SHT31_MEASURE_DELAY;
-                    
-                    sprintf(txt,"\n\r(B) SHT31 error: %X, cnt: %d", error, DevCTL.SHT31_errorcnt);
-                    DEBUG_puts(txt);       
-                    
-                    DevCTL.SHT31_errorcnt++;
-                    if(DevCTL.SHT31_errorcnt == SHT31_TIMEOUT_CNT)
-                    {
-                        // wait and try again
-                        DevCTL.SHT31_delaycnt = SHT31_MEASURE_INTERVAL;
-                        DevCTL.SHT31_state = SHT31_WAITING;                        
-                    }
-                    
-                }
+                LOG2(LOG_MOD_DEVCTL, LOG_LEVEL_WARN, "\n\r(A) SHT31 error: %X, cnt: %d", error, DevCTL.SHT31_errorcnt);
+
+                DevCTL.SHT31_errorcnt++;
             }
-            else
-                DevCTL.SHT31_delaycnt--;
-            
-        break;
-        case SHT31_WAITING:
-            
-            if(DevCTL.SHT31_delaycnt == 0)
+        }
+
+        if(DevCTL.SHT31_state == SHT31_UNINITIALIZED)
+        {
+            // wait a couple of seconds and try to initialize again
+            CR_SLEEP(&DevCTL.SHT31_cr, skiprate,
+                     (DevCTL.SHT31_errorcnt == SHT31_TIMEOUT_CNT) ? SHT31_MEASURE_INTERVAL : SHT31_MEASURE_DELAY);
+        }
+    }
+
+    while(1)
+    {
+        // wait for the measurement to complete
+        CR_SLEEP(&DevCTL.SHT31_cr, skiprate, SHT31_MEASURE_DELAY);
+
+        error = SHT3X_ReadTempAndHumi_Polling(&DevCTL.SHT31_temp, &DevCTL.SHT31_hum); 
+
+        if(error == NO_ERROR)
+        {
+            LOG2(LOG_MOD_DEVCTL, LOG_LEVEL_INFO, "\n\rtemp: %3.2f, humidity: %3.2f", LOG_FLOAT(DevCTL.SHT31_temp), LOG_FLOAT(DevCTL.SHT31_hum));
+
+            DevCTL.SHT31_state = SHT31_WAITING;
+            DevCTL.SHT31_errorcnt = 0;
+        }
+        else
+        {
+            LOG2(LOG_MOD_DEVCTL, LOG_LEVEL_WARN, "\n\r(B) SHT31 error: %X, cnt: %d", error, DevCTL.SHT31_errorcnt);
+
+            // try to read again, give up after SHT31_TIMEOUT_CNT errors
+            DevCTL.SHT31_errorcnt++;
+            if(DevCTL.SHT31_errorcnt == SHT31_TIMEOUT_CNT)
             {
-                // start Measurement
-                error = SHT3X_StartMeasurement_Polling(REPEATAB_HIGH);
+                DevCTL.SHT31_state = SHT31_WAITING;                        
+            }
+        }
 
-                if(error == NO_ERROR)
-                {
-                    DevCTL.SHT31_state = SHT31_MEASURING;
-                    DevCTL.SHT31_delaycnt = SHT31_MEASURE_DELAY;
-                }
-                else
-                {
-                    // wait a couple of seconds and try to initialize again
-                    DevCTL.SHT31_delaycnt = SHT31_MEASURE_DELAY;
+        if(DevCTL.SHT31_state == SHT31_WAITING)
+        {
+            CR_SLEEP(&DevCTL.SHT31_cr, skiprate, SHT31_MEASURE_INTERVAL);
 
-                    sprintf(txt,"\n\r(C) SHT31 error: %X", error);
-                    DEBUG_puts(txt);                        
+            // start next measurement, retry until the sensor accepts the command
+            while((error = SHT3X_StartMeasurement_Polling(REPEATAB_HIGH)) != NO_ERROR)
+            {
+                LOG1(LOG_MOD_DEVCTL, LOG_LEVEL_WARN, "\n\r(C) SHT31 error: %X", error);
 
-                }
+                CR_SLEEP(&DevCTL.SHT31_cr, skiprate, SHT31_MEASURE_DELAY);
             }
-            else
-                DevCTL.SHT31_delaycnt--;
-            
-        break;
-            
+
+            DevCTL.SHT31_state = SHT31_MEASURING;
+        }
     }
-    
+
+    CR_END(&DevCTL.SHT31_cr);
+}
+
+// SHT31 measurement task, registered separately from DeviceControl_Task so the
+// 2 minute measurement interval is a single task skiprate
+void DeviceControl_SHT31_Task(void *pvParameters, DWORD *skiprate)
+{
+    DeviceControl_SHT31_StateMachine(skiprate);
 }
 
 
@@ -448,7 +426,7 @@ void DeviceControl_Testmode(BYTE mode)
     {
         DevCTL.state = DEVCTL_STATE_TESTMODE1;
         DevCTL.substate = 0;
-        DevCTL.delaycnt = 0;
+        SoftTimer_Start(&DevCTL.timer, DEVICE_CONTROL_PWM_TIMEOUT_INIT, 0, NULL);
         
         // disable fan control
         FanSpeedControl_Ramp(0, 0, 0, 2); 
@@ -481,7 +459,7 @@ void DeviceControl_SetMode(BYTE mode)
 
             DevCTL.state = 0;   // uninitialized
 
-            DevCTL.delaycnt = 0;            
+            SoftTimer_Stop(&DevCTL.timer);
             
         break;
 
@@ -551,16 +529,8 @@ void DeviceControl_Slave_Task()
     {
         case DEVCTL_STATE_UNINITIALIZED:     // uninitialized
             
-            if(DevCTL.delaycnt == 0)
-            {
-                // get initial fan control setting
-                FanControl_getFanLevel(&DevCTL.fanspeed, &DevCTL.fandir);    
-                
-                sprintf(txt,"DEVCTL: initial fan speed: %d, dir: %d.\n\r",DevCTL.fanspeed, DevCTL.fandir);
-                DEBUG_puts(txt);                     
-            }
-            
-            if(++DevCTL.delaycnt == DEVICE_CONTROL_PWM_TIMEOUT_INIT)
+            // second fan control reading after the timeout
+            if(SoftTimer_Expired(&DevCTL.timer))
             {
                 
                 DevCTL.fanspeed_last = DevCTL.fanspeed;
@@ -596,27 +566,35 @@ void DeviceControl_Slave_Task()
                     
                    
                     DevCTL.state = DEVCTL_STATE_INITIALIZED;   // go to initialized state
-                    DevCTL.delaycnt = 0;
+                    SoftTimer_Start(&DevCTL.timer, DEVICE_CONTROL_PWM_TIMEOUT_INIT, 0, NULL);
                 }
                 else
                 {
 
-                    sprintf(txt,"DEVCTL #1: new fan speed: %d, dir: %d.\n\r",DevCTL.fanspeed, DevCTL.fandir);
-                    DEBUG_puts(txt);                     
+                    LOG2(LOG_MOD_DEVCTL, LOG_LEVEL_INFO, "DEVCTL #1: new fan speed: %d, dir: %d.\n\r", DevCTL.fanspeed, DevCTL.fandir);
 
                     // update fan speed
                     FanSpeedControl_Ramp(DevCTL.fandir, FAN_STARTUP_DELAY, DevCTL.fanspeed, 2);                    
                     
                     DevCTL.state = DEVCTL_STATE_INITIALIZED;   // go to initialized state
-                    DevCTL.delaycnt = 1;                
+                    SoftTimer_Start(&DevCTL.timer, DEVICE_CONTROL_PWM_TIMEOUT_INIT, 0, NULL);
                 }                
             }
+            else if(!SoftTimer_IsRunning(&DevCTL.timer))
+            {
+                // get initial fan control setting
+                FanControl_getFanLevel(&DevCTL.fanspeed, &DevCTL.fandir);    
+                
+                LOG2(LOG_MOD_DEVCTL, LOG_LEVEL_INFO, "DEVCTL: initial fan speed: %d, dir: %d.\n\r", DevCTL.fanspeed, DevCTL.fandir);
+
+                SoftTimer_Start(&DevCTL.timer, DEVICE_CONTROL_PWM_TIMEOUT_INIT, 0, NULL);
+            }
 
             
         break;
         case DEVCTL_STATE_INITIALIZED:     // initialized state
                        
-            if(++DevCTL.delaycnt == DEVICE_CONTROL_PWM_TIMEOUT_INIT)
+            if(SoftTimer_Expired(&DevCTL.timer))
             {
                 
                 DevCTL.fanspeed_last = DevCTL.fanspeed;
@@ -631,14 +609,13 @@ void DeviceControl_Slave_Task()
                     // fan PWM control signal seems to be stable. Adjust valve setting accordingly
                     
                     DevCTL.state = DEVCTL_STATE_INITIALIZED;   // go to initialized state
-                    DevCTL.delaycnt = 0;
+                    SoftTimer_Start(&DevCTL.timer, DEVICE_CONTROL_PWM_TIMEOUT_INIT, 0, NULL);
                 }
                 else
                 {
                     // fan speed or direction changed
                     
-                    sprintf(txt,"DEVCTL #2: new fan speed: %d, dir: %d.\n\r",DevCTL.fanspeed, DevCTL.fandir);
-                    DEBUG_puts(txt);                        
+                    LOG2(LOG_MOD_DEVCTL, LOG_LEVEL_INFO, "DEVCTL #2: new fan speed: %d, dir: %d.\n\r", DevCTL.fanspeed, DevCTL.fandir);
                     
                     if(DevCTL.fanspeed == 0)
                     {
@@ -650,7 +627,7 @@ void DeviceControl_Slave_Task()
                       
                         
                         DevCTL.state = DEVCTL_STATE_ZEROCROSS;   // go to zero crossing special state
-                        DevCTL.delaycnt = 0;                        
+                        SoftTimer_Start(&DevCTL.timer, DEVICE_CONTROL_PWM_TIMEOUT_ZEROCROSS, 0, NULL);
                     }
                     else
                     {
@@ -671,7 +648,7 @@ void DeviceControl_Slave_Task()
                         
                         
                         DevCTL.state = DEVCTL_STATE_INITIALIZED;   // go to initialized state
-                        DevCTL.delaycnt = 0;                        
+                        SoftTimer_Start(&DevCTL.timer, DEVICE_CONTROL_PWM_TIMEOUT_INIT, 0, NULL);
                     }
                     
                     
@@ -685,7 +662,7 @@ void DeviceControl_Slave_Task()
         break;
         case DEVCTL_STATE_ZEROCROSS:     // zero crossing special case
 
-            if(++DevCTL.delaycnt == DEVICE_CONTROL_PWM_TIMEOUT_ZEROCROSS)
+            if(SoftTimer_Expired(&DevCTL.timer))
             {
                 
                 DevCTL.fanspeed_last = DevCTL.fanspeed;
@@ -715,19 +692,18 @@ void DeviceControl_Slave_Task()
                     }  
                     
                     DevCTL.state = DEVCTL_STATE_INITIALIZED;   // go to initialized state
-                    DevCTL.delaycnt = 0;
+                    SoftTimer_Start(&DevCTL.timer, DEVICE_CONTROL_PWM_TIMEOUT_INIT, 0, NULL);
                 }  
                 else
                 {
-                    sprintf(txt,"DEVCTL #3: new fan speed: %d, dir: %d.\n\r",DevCTL.fanspeed, DevCTL.fandir);
-                    DEBUG_puts(txt);                     
+                    LOG2(LOG_MOD_DEVCTL, LOG_LEVEL_INFO, "DEVCTL #3: new fan speed: %d, dir: %d.\n\r", DevCTL.fanspeed, DevCTL.fandir);
                     
                     // change fan speed
                     FanSpeedControl_Ramp(DevCTL.fandir, 0, DevCTL.fanspeed, 2);                       
                     
                     // signal keeps changing. Go back to initialized state
                     DevCTL.state = DEVCTL_STATE_INITIALIZED;   // go to initialized state
-                    DevCTL.delaycnt = 0;                    
+                    SoftTimer_Start(&DevCTL.timer, DEVICE_CONTROL_PWM_TIMEOUT_INIT, 0, NULL);
                 }
             }
             
@@ -738,22 +714,22 @@ void DeviceControl_Slave_Task()
         case DEVCTL_STATE_TESTMODE1:    // alternating open / close
             
             
-            if(++DevCTL.delaycnt == DEVICE_CONTROL_PWM_TIMEOUT_INIT)
+            if(SoftTimer_Expired(&DevCTL.timer))
             {
                 if(Valve_isClosed())
                 {
                     Valve_Open(63, 0);
-                    DevCTL.delaycnt = 0;
+                    SoftTimer_Start(&DevCTL.timer, DEVICE_CONTROL_PWM_TIMEOUT_INIT, 0, NULL);
                 }
                 else if(Valve_isOpened())
                 {
                     Valve_Close(63, 0); 
-                    DevCTL.delaycnt = 0;
+                    SoftTimer_Start(&DevCTL.timer, DEVICE_CONTROL_PWM_TIMEOUT_INIT, 0, NULL);
                     
                 }
                 else
                 {
-                    DevCTL.delaycnt = 0;    // wait
+                    SoftTimer_Start(&DevCTL.timer, DEVICE_CONTROL_PWM_TIMEOUT_INIT, 0, NULL);    // wait
                 }
             }
                 
@@ -765,15 +741,79 @@ void DeviceControl_Slave_Task()
 
 
 
+// push the subscribed status bytes that changed since the last notification
+static void DeviceControl_Notify_Task()
+{
+    BYTE status[DEVCTL_STATUS_LEN];
+    BYTE notify[3 + DEVCTL_STATUS_LEN];
+    WORD len, changed = 0;
+    BYTE i, n = 3;
+
+    if(DevCTL.notifyMask == 0 || SoftTimer_IsRunning(&DevCTL.notifyTimer))
+    {
+        return;
+    }
+
+    DeviceControl_StatusBTCom(status, &len);
+
+    for(i=1; i<DEVCTL_STATUS_LEN; i++)
+    {
+        if((DevCTL.notifyMask & (1 << i)) && (!DevCTL.notifyValid || status[i] != DevCTL.notifyLast[i]))
+        {
+            changed |= (1 << i);
+            notify[n++] = status[i];
+        }
+    }
+
+    if(changed == 0)
+    {
+        return;
+    }
+
+    // <cmd> <changed mask> <changed bytes in ascending order>
+    notify[0] = CMD_STATUS_NOTIFY;
+    notify[1] = changed >> 8;
+    notify[2] = changed & 0xFF;
+
+    // transmitter busy: retry next tick
+    if(!BTCom_PutNotification(notify, n))
+    {
+        return;
+    }
+
+    memcpy(DevCTL.notifyLast, status, DEVCTL_STATUS_LEN);
+    DevCTL.notifyValid = 1;
+
+    if(DevCTL.notifyInterval > 0)
+    {
+        SoftTimer_Start(&DevCTL.notifyTimer, SOFTTIMER_MS(DevCTL.notifyInterval), 0, NULL);
+    }
+}
+
+// subscribe to status changes (mask 0 unsubscribes), the first notification
+// contains all subscribed bytes. returns the accepted mask
+WORD DeviceControl_Subscribe(WORD mask, WORD interval)
+{
+    DevCTL.notifyMask = mask & DEVCTL_NOTIFY_MASK_VALID;
+    DevCTL.notifyInterval = interval;
+    DevCTL.notifyValid = 0;
+    SoftTimer_Stop(&DevCTL.notifyTimer);
+
+    return DevCTL.notifyMask;
+}
+
+// BLE connection made or lost: subscriptions belong to the old session
+void DeviceControl_LinkChanged()
+{
+    DeviceControl_Subscribe(0, 0);
+}
+
+
 // -react on changes of measured PWM control signal
 // -handle fan control
 // -offer test modes for debugging
-void DeviceControl_Task(void *pvParameters, BYTE *skiprate)
+void DeviceControl_Task(void *pvParameters, DWORD *skiprate)
 {
-	
-    // perform SHT31 measurement
-    DeviceControl_SHT31_StateMachine();
-    
 	// period: every 250ms sufficient?
 	
     switch(DevCTL.mode)
@@ -789,6 +829,7 @@ void DeviceControl_Task(void *pvParameters, BYTE *skiprate)
         break;
     }
 
+    DeviceControl_Notify_Task();
     
     *skiprate = 1;    
 }
@@ -797,7 +838,7 @@ void DeviceControl_Task(void *pvParameters, BYTE *skiprate)
 
 
 // assemble status message to sent via BLE interface
-void DeviceControl_StatusBTCom(BYTE *outbuf, BYTE *len)
+void DeviceControl_StatusBTCom(BYTE *outbuf, WORD *len)
 {
 //    FLOAT_VAL   fVal;
 //    WORD_VAL    wVal;
@@ -859,5 +900,5 @@ void DeviceControl_StatusBTCom(BYTE *outbuf, BYTE *len)
     outbuf[13] = DevCTL.state;
 
     
-    *len = 16;
+    *len = DEVCTL_STATUS_LEN;
 }
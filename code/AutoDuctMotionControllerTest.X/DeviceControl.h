@@ -9,14 +9,17 @@
 #include <GenericTypeDefs.h>
 
 void DeviceControl_Init();
-void DeviceControl_Task(void *pvParameters, BYTE *skiprate);
+void DeviceControl_Task(void *pvParameters, DWORD *skiprate);
+void DeviceControl_SHT31_Task(void *pvParameters, DWORD *skiprate);
 void DeviceControl_Testmode(BYTE mode);
 void DeviceControl_ManualVent(BYTE fanmode, BYTE fandir, BYTE fanspeed, BYTE minutes);
-void DeviceControl_StatusBTCom(BYTE *outbuf, BYTE *len);
+void DeviceControl_StatusBTCom(BYTE *outbuf, WORD *len);
 void DeviceControl_SetMode(BYTE mode);
 BYTE DeviceControl_GetMode();
 void DeviceControl_AcknowledgeLED();
 void DeviceControl_SmartVent(BYTE fanmode, BYTE fandir, BYTE fanspeed, BYTE minutes);
+WORD DeviceControl_Subscribe(WORD mask, WORD interval);
+void DeviceControl_LinkChanged();
 
 #define DEVICEMODE_SLAVE        0
 #define DEVICEMODE_MANUAL       1
@@ -33,10 +36,15 @@ void DeviceControl_SmartVent(BYTE fanmode, BYTE fandir, BYTE fanspeed, BYTE minu
 
 #define FAN_STARTUP_DELAY                       600
 
+#define DEVCTL_STATUS_LEN                       16      // CMD_STATUS response length
+#define DEVCTL_NOTIFY_MASK_VALID                0xFFFE  // status bytes 1..15
+#define CMD_STATUS_NOTIFY                       0x0D    // status change notification
+
 #define SHT31_UNINITIALIZED                     0x00
 #define SHT31_MEASURING                         0x01
 #define SHT31_WAITING                           0x02
 
+#define SHT31_RESET_DELAY                       13 // 52ms, see SHT3X_SOFTRESET_TIME_MS
 #define SHT31_MEASURE_DELAY                     5 // 20ms       1250    // 5 seconds
 #define SHT31_MEASURE_INTERVAL                  30000   // 2 minutes
 #define SHT31_TIMEOUT_CNT                       5
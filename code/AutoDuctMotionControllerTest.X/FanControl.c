@@ -3,6 +3,8 @@
 
 
 #include "Fancontrol.h"
+#include "EventQueue.h"
+#include "Log.h"
 
 /*
  This module performs the following tasks:
@@ -60,6 +62,11 @@ const BYTE ctlsignal_pwm_table_output[5] = {
 FanCTLData FanCTL;
 PWMsenseData PWMsense;
 
+// capture results posted by the IC1 ISR, param1 = period, param2 = pulse
+EventQueueStruct PWMsense_events;
+
+#define FANCTL_EVENT_CAPTURE    1
+
 WORD samp[4];
 char txt[250];
 
@@ -74,7 +81,11 @@ void SetupPWM_InputCapture()
 	WORD j;
 
     PWMsense.sampcnt = 0;
+    PWMsense.capcnt = 0;
     PWMsense.state = 0;     // idle
+
+    // IC1 interrupt is disabled here, safe to reset the queue
+    EventQueue_Init(&PWMsense_events);
     
     
     // uses timer2 (shared with OC3 - setup in ledfade.c)
@@ -109,7 +120,8 @@ void SetupPWM_InputCapture()
 }
 
 // interrupt service routine for input capture module
-void __ISR(_INPUT_CAPTURE_1_VECTOR , ipl5) _IC1Interrupt(void)
+// measured values are passed to FanControl_Task via PWMsense_events
+void __ISR(_INPUT_CAPTURE_1_VECTOR , ipl1) _IC1Interrupt(void)
 {
     WORD i;
     
@@ -124,15 +136,11 @@ void __ISR(_INPUT_CAPTURE_1_VECTOR , ipl5) _IC1Interrupt(void)
         samp[i] = IC1BUF; // Read and save off capture entry
     }    
 
-    PWMsense.samp_period[PWMsense.sampcnt] = samp[2] - samp[0];
-    PWMsense.samp_pulse[PWMsense.sampcnt] = samp[1] - samp[0];
+    EventQueue_Post(&PWMsense_events, FANCTL_EVENT_CAPTURE, samp[2] - samp[0], samp[1] - samp[0]);
     
-    if(++PWMsense.sampcnt == (NUM_PWM_SAMPLES+1))
+    if(++PWMsense.capcnt == (NUM_PWM_SAMPLES+1))
     {
-        // sample buffer full. Stop sampling
-        PWMsense.sampcnt = 0;
-        PWMsense.state = 0;
-        
+        // enough samples for one measurement. Stop sampling
         IC1CONbits.ON = 0;  // disable IC module
         
         IEC0bits.IC1IE = 0; // disable IC1 interrupts	
@@ -227,7 +235,7 @@ BYTE FanControl_Level2pwm(BYTE level)
 
 
 // main fan control state machine task
-void FanControl_Task(void *pvParameters, BYTE *skiprate)
+void FanControl_Task(void *pvParameters, DWORD *skiprate)
 {
     WORD i;
 	BYTE updatePWM;
@@ -235,6 +243,23 @@ void FanControl_Task(void *pvParameters, BYTE *skiprate)
     
     DWORD periodavg, pulseavg;
     signed int period_dev, pulse_dev, perd, puld;
+    EventStruct ev;
+    
+    // collect the samples captured since the last call
+    while(EventQueue_Get(&PWMsense_events, &ev))
+    {
+        if(PWMsense.state == 1 && ev.type == FANCTL_EVENT_CAPTURE)
+        {
+            PWMsense.samp_period[PWMsense.sampcnt] = ev.param1;
+            PWMsense.samp_pulse[PWMsense.sampcnt] = ev.param2;
+            
+            if(++PWMsense.sampcnt == (NUM_PWM_SAMPLES+1))
+            {
+                // sample buffer full, sampling was stopped by the ISR
+                PWMsense.state = 0;
+            }
+        }
+    }
     
     if(PWMsense.state == 0)
     {
@@ -322,12 +347,10 @@ void FanControl_Task(void *pvParameters, BYTE *skiprate)
 			// do nothing
 		break;
 		case 1: // Waiting to fade up
-			if(FanCTL.delaycnt==0)
+			if(SoftTimer_Expired(&FanCTL.delaytimer))
 			{
 				FanCTL.state = 2;
 			}
-			else
-				FanCTL.delaycnt--;
 		break;			
 		case 2:	// Fade Up
 			if(++FanCTL.delaycnt>=FanCTL.fadespeed)
@@ -342,12 +365,10 @@ void FanControl_Task(void *pvParameters, BYTE *skiprate)
 			}		
 		break;
 		case 3: // Waiting to fade down
-			if(FanCTL.delaycnt==0)
+			if(SoftTimer_Expired(&FanCTL.delaytimer))
 			{
 				FanCTL.state = 4;
 			}
-			else
-				FanCTL.delaycnt--;	
 		break;		
 		case 4:	// Fade Down
 			if(++FanCTL.delaycnt>=FanCTL.fadespeed)
@@ -406,7 +427,8 @@ void FanSpeedControl_Ramp(BYTE dir, WORD fdelay, BYTE level, WORD rampspeed)
 		else
 			FanCTL.state = 4;		
 	}
-	FanCTL.delaycnt = fdelay;
+	SoftTimer_Start(&FanCTL.delaytimer, fdelay, 0, NULL);
+	FanCTL.delaycnt = 0;
 	FanCTL.targetspeed = trpm;
 	FanCTL.fadespeed = rampspeed;
     
@@ -416,8 +438,7 @@ void FanSpeedControl_Ramp(BYTE dir, WORD fdelay, BYTE level, WORD rampspeed)
         FanCTL.dir = FAN_DIR_OUTWARDS;    
     
     
-            sprintf(txt,"FANCTL: trpm = %d.\n\r",trpm);
-            DEBUG_puts(txt);       
+            LOG1(LOG_MOD_FANCTL, LOG_LEVEL_INFO, "FANCTL: trpm = %d.\n\r", trpm);
     
 }	
 
@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include "HardwareProfile.h"
 #include <GenericTypeDefs.h>
+#include "SoftTimer.h"
 
 
 
@@ -43,17 +44,19 @@ typedef struct FanCTL_Struct
 	BYTE speed, targetspeed;
     BYTE fanlevel;                  // just for display purposes in App
 	WORD fadespeed;
-	WORD delaycnt;
+	WORD delaycnt;                  // ramp step counter
+	SoftTimerStruct delaytimer;     // ramp start delay
     // FanCTLSequenceData Sequence;
 }FanCTLData;	
 
 // data structure for PWM measurement state machine
 typedef struct PWMsense_Struct
 {
-    volatile BYTE state;             // state machine state
+    BYTE state;             // state machine state (1 = sampling)
     WORD samp_period[NUM_PWM_SAMPLES+1];   // sample buffer period measurement
     WORD samp_pulse[NUM_PWM_SAMPLES+1];    // sample buffer pulse width measurement
     BYTE sampcnt;           // sample index counter
+    BYTE capcnt;            // capture counter (ISR only)
     
     WORD PWM_pulse;
     WORD PWM_period;
@@ -65,7 +68,7 @@ typedef struct PWMsense_Struct
 
 
 void FanControl_Init();
-void FanControl_Task(void *pvParameters, BYTE *skiprate);
+void FanControl_Task(void *pvParameters, DWORD *skiprate);
 void FanControl_getFanLevel(BYTE *level, BYTE *dir);
 void FanSpeedControl_Ramp(BYTE dir, WORD fdelay, BYTE level, WORD rampspeed);
 BYTE FanSpeedControl_getSpeed();
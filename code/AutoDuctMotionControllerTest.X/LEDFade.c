@@ -3,6 +3,9 @@
 
 #include "LEDFade.h"
 
+// task cycle time in scheduler ticks, fade delays are given in task cycles
+#define LEDFADE_TASK_PERIOD     3
+
 // 10-bit brightness table
 const WORD pwmtable_10[64] = {
 0x0000,0x0001,0x0001,0x0002,0x0002,0x0002,0x0002,0x0002,0x0003,0x0003,0x0003,0x0004,0x0004,0x0005,0x0005,0x0006,
@@ -176,7 +179,8 @@ void LEDFade_Fade(BYTE led, WORD fdelay, BYTE tbright, WORD fspeed)
 		else
 			ledFade[led].state = 4;		
 	}
-	ledFade[led].FadeDelay = fdelay;
+	SoftTimer_Start(&ledFade[led].delaytimer, (DWORD)fdelay * LEDFADE_TASK_PERIOD, 0, NULL);
+	ledFade[led].FadeDelay = 0;
 	ledFade[led].targetbright = tbright;
 	ledFade[led].fadespeed = fspeed;
 }	
@@ -238,12 +242,12 @@ void LEDFade_Disable(BYTE led)
 
 
 
-void LEDFade_Task(void *pvParameters, BYTE *skiprate)
+void LEDFade_Task(void *pvParameters, DWORD *skiprate)
 {
     BYTE led,updatePWM,loop;
     WORD brcalc;
 
-	*skiprate = 3;		// default skiprate for all states	
+	*skiprate = LEDFADE_TASK_PERIOD;		// default skiprate for all states	
 	
  
     for(led=0; led<NUM_LEDS; led++)
@@ -285,7 +289,7 @@ void LEDFade_Task(void *pvParameters, BYTE *skiprate)
                             case CMD_PAUSE:
                                 // arg1 = duration (0...255), duration = arg1 * 60ms (~15sec max.)
                                 ledFade[led].Sequence.state = 2;
-                                ledFade[led].Sequence.counter = ledFade[led].Sequence.seq[ledFade[led].Sequence.index+1]*5;
+                                SoftTimer_Start(&ledFade[led].Sequence.timer, SOFTTIMER_MS(ledFade[led].Sequence.seq[ledFade[led].Sequence.index+1]*60), 0, NULL);
                                 ledFade[led].Sequence.index+=2;
                                 loop = 0;   // do not continue with next command 
                             break;
@@ -350,8 +354,8 @@ void LEDFade_Task(void *pvParameters, BYTE *skiprate)
 
             break;
             case 2:
-                // wait state (task cycle time 3*4ms)
-                if(--ledFade[led].Sequence.counter == 0)
+                // wait state
+                if(SoftTimer_Expired(&ledFade[led].Sequence.timer))
                 {
                     // continue with command execution
                     ledFade[led].Sequence.state = 1; 
@@ -373,12 +377,10 @@ void LEDFade_Task(void *pvParameters, BYTE *skiprate)
                 // do nothing
             break;
             case 1: // Waiting to fade up
-                if(ledFade[led].FadeDelay==0)
+                if(SoftTimer_Expired(&ledFade[led].delaytimer))
                 {
                     ledFade[led].state = 2;
                 }
-                else
-                    ledFade[led].FadeDelay--;
             break;			
             case 2:	// Fade Up
                 if(++ledFade[led].FadeDelay>=ledFade[led].fadespeed)
@@ -393,12 +395,10 @@ void LEDFade_Task(void *pvParameters, BYTE *skiprate)
                 }		
             break;
             case 3: // Waiting to fade down
-                if(ledFade[led].FadeDelay==0)
+                if(SoftTimer_Expired(&ledFade[led].delaytimer))
                 {
                     ledFade[led].state = 4;
                 }
-                else
-                    ledFade[led].FadeDelay--;	
             break;		
             case 4:	// Fade Down
                 if(++ledFade[led].FadeDelay>=ledFade[led].fadespeed)
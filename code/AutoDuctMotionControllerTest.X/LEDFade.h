@@ -8,10 +8,11 @@
 #include <stdio.h>
 #include "HardwareProfile.h"
 #include <GenericTypeDefs.h>
+#include "SoftTimer.h"
 
 
 void LEDFade_Init();
-void LEDFade_Task(void *pvParameters, BYTE *skiprate);
+void LEDFade_Task(void *pvParameters, DWORD *skiprate);
 void LEDFade_Fade(BYTE led, WORD delay, BYTE tbright, WORD fspeed);
 void LEDFade_SetBrightness(BYTE led, BYTE br);
 void LEDFade_SetGlobalBrightness(BYTE led, BYTE gbr);
@@ -23,7 +24,7 @@ BYTE LEDFade_getTaskState(BYTE led);
 typedef struct BTLEDSequence_Struct
 {
 	BYTE state;
-	WORD counter;
+	SoftTimerStruct timer;  // pause timer
     BYTE index;
     BYTE *seq;
     BYTE *seqnext;
@@ -35,7 +36,8 @@ typedef struct LEDFade_Struct
 	BYTE state;
 	BYTE bright, targetbright, globalbright, dynmax;
 	WORD fadespeed;
-	WORD FadeDelay;
+	WORD FadeDelay;             // fade step counter
+	SoftTimerStruct delaytimer; // fade start delay
     BTLEDSequenceData Sequence;
 }LEDFadeData;	
 
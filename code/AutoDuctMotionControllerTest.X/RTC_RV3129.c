@@ -148,6 +148,51 @@ BYTE rv3129_read_reg(BYTE address, BYTE *data, BYTE length)
 
 
 
+// coroutine step of a register group read into ctx->raw[] (length <=
+// RV3129_CR_MAX_REGS). the group is read in one burst transaction, the RTC
+// latches the clock registers for it, so time and date can not tear
+// (e.g. 13:59 at the hour roll-over). callers yield between groups only
+BYTE rv3129_read_reg_cr(RV3129ReadContext *ctx, BYTE address, BYTE length)
+{
+    CR_BEGIN(&ctx->cr);
+
+    rv3129_read_reg(address, ctx->raw, length);
+
+    CR_END(&ctx->cr);
+}
+
+// yielding variant of rtc_get_time(), results are written when CR_DONE is returned
+BYTE rtc_get_time_cr(RV3129ReadContext *ctx, BYTE* hour, BYTE* min, BYTE* sec)
+{
+    if(rv3129_read_reg_cr(ctx, REG_CLOCK_SEC, 3) == CR_WAITING)
+    {
+        return CR_WAITING;
+    }
+
+	*sec = bcd2dec(ctx->raw[0]);
+	*min = bcd2dec(ctx->raw[1]);
+	*hour = bcd2dec(ctx->raw[2] & 0b00111111);
+
+    return CR_DONE;
+}
+
+// yielding variant of rtc_get_date(), results are written when CR_DONE is returned
+BYTE rtc_get_date_cr(RV3129ReadContext *ctx, BYTE* weekday, BYTE* day, BYTE* month, WORD* year)
+{
+    // registers: day, weekday, month, year
+    if(rv3129_read_reg_cr(ctx, REG_CLOCK_DAY, 4) == CR_WAITING)
+    {
+        return CR_WAITING;
+    }
+
+	*day     = bcd2dec(ctx->raw[0] & 0b00111111);
+	*weekday = ctx->raw[1] & 0b00000111;
+	*month   = bcd2dec(ctx->raw[2] & 0b00011111);
+	*year    = bcd2dec(ctx->raw[3]) + 2000;
+
+    return CR_DONE;
+}
+
 // read time from RV3129
 void rtc_get_time(BYTE* hour, BYTE* min, BYTE* sec)
 {
@@ -6,11 +6,25 @@
 #include "Compiler.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include "Coroutine.h"
 
 #define bcd2dec(bcd)	(((((bcd)>>4) & 0x0F) * 10) + ((bcd) & 0x0F)) 
 #define dec2bcd(dec)	((((dec)/10)<<4)|((dec)%10)) 
 
 
+// state of a yielding register read
+#define RV3129_CR_MAX_REGS      4
+
+typedef struct
+{
+    CoroutineStruct cr;
+    BYTE raw[RV3129_CR_MAX_REGS];
+}RV3129ReadContext;
+
+BYTE rv3129_read_reg_cr(RV3129ReadContext *ctx, BYTE address, BYTE length);
+BYTE rtc_get_time_cr(RV3129ReadContext *ctx, BYTE* hour, BYTE* min, BYTE* sec);
+BYTE rtc_get_date_cr(RV3129ReadContext *ctx, BYTE* weekday, BYTE* day, BYTE* month, WORD* year);
+
 void rtc_get_time(BYTE* hour, BYTE* min, BYTE* sec);
 void rtc_set_time(BYTE hour, BYTE min, BYTE sec, BYTE hourmode);
 void rtc_get_date(BYTE* weekday, BYTE* day, BYTE* month, WORD* year);
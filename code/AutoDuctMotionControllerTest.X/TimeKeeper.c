@@ -6,6 +6,7 @@
 #include "TaskScheduler.h"
 #include "DeviceControl.h"
 #include "RTC_RV3129.h"
+#include "Log.h"
 #include <time.h>
 
 #define TC_NUM_ROOMS				1 		// numer of rooms to control
@@ -20,6 +21,9 @@ TimeStruct gLastTime;
 DateStruct gDate;
 DateStruct gLastDate;
 
+static CoroutineStruct TK_update_cr;
+static RV3129ReadContext TK_rtc_ctx;
+
 
 #define NUM_TIMEOUT_EVENTS	7
 TimeoutEvent Timeout[NUM_TIMEOUT_EVENTS];
@@ -44,18 +48,19 @@ char txt[60];
 void TimeKeeper_checkTimeoutEvents(BYTE MinutesPassed);
 
 
-void puts_weekday(BYTE weekday)
+// weekday (1..7) 1 = Sunday as constant string, usable as "%s" log argument
+static const char *weekday_string(BYTE weekday)
 {
     switch(weekday)
     {
-        case 1: DEBUG_puts("Sunday"); break;
-        case 2: DEBUG_puts("Monday"); break;
-        case 3: DEBUG_puts("Tuesday"); break;
-        case 4: DEBUG_puts("Wednesday"); break;
-        case 5: DEBUG_puts("Thursday"); break;
-        case 6: DEBUG_puts("Friday"); break;
-        case 7: DEBUG_puts("Saturday"); break;        
-        default: DEBUG_puts("-undefined-"); break;        
+        case 1: return "Sunday";
+        case 2: return "Monday";
+        case 3: return "Tuesday";
+        case 4: return "Wednesday";
+        case 5: return "Thursday";
+        case 6: return "Friday";
+        case 7: return "Saturday";
+        default: return "-undefined-";
     }
 }
 
@@ -130,7 +135,6 @@ BYTE getPrevNextEventToday(BYTE day, BYTE hour, BYTE min, BYTE *prevID, BYTE *ne
 {
     BYTE idprev=0xFF, idnext=0xFF, i;
     signed int nextdist, prevdist, dist;
-    char txt[100];
 
     for(i = 0; i<TC_NUM_EVENTS; i++)
     {
@@ -139,8 +143,7 @@ BYTE getPrevNextEventToday(BYTE day, BYTE hour, BYTE min, BYTE *prevID, BYTE *ne
             // calculate time in minutes to current event
             dist = (CFGventSched.hour[day][i] - hour) * 60 + (CFGventSched.min[day][i] - min);            
 
-            sprintf(txt,"\n\rday: %u, ID: %u, dist: %i",day,i,dist);
-            DEBUG_puts(txt);
+            LOG3(LOG_MOD_TIMEKEEPER, LOG_LEVEL_DEBUG, "\n\rday: %u, ID: %u, dist: %i", day, i, dist);
 
             if(dist > 0)
             {
@@ -205,7 +208,6 @@ void TimeKeeper_CheckScheduleUpdates(BYTE weekday, BYTE hour, BYTE minute)
     BYTE previd, nextid, prevday, junk;
     BYTE fanmode, fandir, fanspeed;
     signed int prevdist;
-    char txt[100];
 
     // Timekeeper: wday (0..6) 0 = Sunday
     // RV3049 / Android: wday (1..7) 1 = Sunday
@@ -262,7 +264,7 @@ void TimeKeeper_CheckScheduleUpdates(BYTE weekday, BYTE hour, BYTE minute)
     // done looking for last switching event
     if(previd == 0xFF)
     {
-        DEBUG_puts("\n\rNo Schedule Events defined. ");
+        LOG(LOG_MOD_TIMEKEEPER, LOG_LEVEL_INFO, "\n\rNo Schedule Events defined. ");
 
     }
     else
@@ -275,10 +277,7 @@ void TimeKeeper_CheckScheduleUpdates(BYTE weekday, BYTE hour, BYTE minute)
         }
         else
         {
-            sprintf(txt,"\n\rnew previd: %u, prevday: %u (today: %u ",previd,prevday,weekday);
-            DEBUG_puts(txt);
-            puts_weekday(weekday+1);
-            DEBUG_puts(")\n\r");
+            LOG4(LOG_MOD_TIMEKEEPER, LOG_LEVEL_INFO, "\n\rnew previd: %u, prevday: %u (today: %u %s)\n\r", previd, prevday, weekday, weekday_string(weekday+1));
 
             // save new event id and day
             lastEvent_ID = previd;
@@ -304,13 +303,12 @@ void TimeKeeper_CheckScheduleUpdates(BYTE weekday, BYTE hour, BYTE minute)
 
 
                 DeviceControl_SmartVent(fanmode, fandir, fanspeed, CFGventSched.duration[prevday][previd]);
-                DEBUG_puts("Activating scheduled venting event:\n\r");
-                sprintf(txt,"fanmode: %u, fandir: %u, fanspeed: %u, duration: %u\n\r",fanmode, fandir, fanspeed, CFGventSched.duration[prevday][previd]);
-                DEBUG_puts(txt);            
+                LOG(LOG_MOD_TIMEKEEPER, LOG_LEVEL_INFO, "Activating scheduled venting event:\n\r");
+                LOG4(LOG_MOD_TIMEKEEPER, LOG_LEVEL_INFO, "fanmode: %u, fandir: %u, fanspeed: %u, duration: %u\n\r", fanmode, fandir, fanspeed, CFGventSched.duration[prevday][previd]);
             }
             else
             {
-                DEBUG_puts("Previous event expired.\n\r");
+                LOG(LOG_MOD_TIMEKEEPER, LOG_LEVEL_INFO, "Previous event expired.\n\r");
             }
             
 
@@ -340,6 +338,8 @@ void TimeKeeper_Init()
 	TK_minuteschanged = 1;
 	TimeKeeper_state = 0;
 	MinutesPassed = 0;
+    CR_INIT(&TK_update_cr);
+    CR_INIT(&TK_rtc_ctx.cr);
     
 	// get Time
 	rtc_get_time(&gLastTime.hour, &gLastTime.min, &gLastTime.sec);
@@ -426,10 +426,11 @@ void TimeKeeper_getTimeDate(BYTE* weekday, BYTE* day, BYTE* month, BYTE* year, B
 }
 
 // read current time from RTC, update date as required.
-// handle daylight saving mode time adjustment
+// handle daylight saving mode time adjustment.
+// coroutine: time and date are read on separate calls, call until CR_DONE
 BYTE TimeKeeper_UpdateTime()
 {
-	BYTE res = 0;
+    CR_BEGIN(&TK_update_cr);
     
 	// save last time
 	gLastTime.hour = gTime.hour;
@@ -437,7 +438,7 @@ BYTE TimeKeeper_UpdateTime()
 	gLastTime.sec = gTime.sec;					
 
 	// read current time from RTC
-	rtc_get_time(&gTime.hour, &gTime.min, &gTime.sec);
+	CR_WAIT_CHILD(&TK_update_cr, rtc_get_time_cr(&TK_rtc_ctx, &gTime.hour, &gTime.min, &gTime.sec));
            
 	
 	// check if hours changed
@@ -446,7 +447,8 @@ BYTE TimeKeeper_UpdateTime()
 		// in case hours wrapped around, read current Date too
 		if(gTime.hour == 0)
 		{
-			rtc_get_date(&gDate.weekday, &gDate.day, &gDate.month, &gDate.year);		
+			CR_YIELD(&TK_update_cr);
+			CR_WAIT_CHILD(&TK_update_cr, rtc_get_date_cr(&TK_rtc_ctx, &gDate.weekday, &gDate.day, &gDate.month, &gDate.year));
 		}	
 		
         if(CFGbase.daylightsavingAuto == 0x01)
@@ -454,11 +456,11 @@ BYTE TimeKeeper_UpdateTime()
             // check rare occasion, if daylight saving time switching must be done
             // if hours just changed, check if we have to adjust current time due to
             // daylight saving mode change
-            res = AdjustDaylightSavingTime();
+            AdjustDaylightSavingTime();
         }
 	}	
 	    
-	return res;
+    CR_END(&TK_update_cr);
 }	
 
 // get time from timekeeper data structure
@@ -496,7 +498,7 @@ BYTE GetPassedMinutesCurrent()
 }	
 
 // main timekeeper state machine task
-void TimeKeeper_Task(void *pvParameters, BYTE *skiprate)
+void TimeKeeper_Task(void *pvParameters, DWORD *skiprate)
 {
 	BYTE i, ms;
 
@@ -505,15 +507,18 @@ void TimeKeeper_Task(void *pvParameters, BYTE *skiprate)
 	{
 		case 0:	// time check
 
-			// get current time
-			TimeKeeper_UpdateTime();
+			// get current time, reading the RTC takes a couple of ticks
+			if(TimeKeeper_UpdateTime() == CR_WAITING)
+			{
+				*skiprate = 1;
+				break;
+			}
 
 			// calculate how many minutes have passed since last TimeUpdate
 			MinutesPassed = GetPassedMinutes(&gTime,&gLastTime);            
             if(MinutesPassed > 0)
             {
-                sprintf(txt,"\n\r -- %02u:%02u",gTime.hour, gTime.min);
-                DEBUG_puts(txt);
+                LOG2(LOG_MOD_TIMEKEEPER, LOG_LEVEL_INFO, "\n\r -- %02u:%02u", gTime.hour, gTime.min);
                 
                 // check if any scheduled venting events need to be activated
                 if(DeviceControl_GetMode() == DEVICEMODE_SMART)
@@ -524,7 +529,7 @@ void TimeKeeper_Task(void *pvParameters, BYTE *skiprate)
                 // check if configuration has changed within the last 10 minutes and need to be saved to external EEPROM
                 if((gTime.min % 10 ) == 0)
                 {
-                    SaveConfig_UdatesOnly();
+                    Config_RequestSave();
                 }
             }
             
@@ -553,7 +558,7 @@ void TimeKeeper_Task(void *pvParameters, BYTE *skiprate)
 		
             TimeKeeper_checkTimeoutEvents(MinutesPassed);
 			TimeKeeper_state = 0;
-			*skiprate = 250;			
+			// next time check after the task period (TIMEKEEPER_PERIOD)
 		break;
 	}	
 }
@@ -676,16 +681,13 @@ void TimeKeeper_checkTimeoutEvents(BYTE MinutesPassed)
 
 // check current time and date configuration
 // + enables correct daylight saving time mode
-// + adjustes current time if necessary
-// returns:
-// 0: nothing changed
-// 1: daylight saving mode disabled, hours decreased
-// 2: daylight saving mode enabled, hours increased
+// + adjustes current time if necessary (the RTC is set directly, callers
+//   see the new hour in gTime)
 //
 // When to call:
 // + on every boot (after TimeKeeper_Init())
 // + everytime hours change
-BYTE AdjustDaylightSavingTime()
+void AdjustDaylightSavingTime()
 {
 	BYTE res;
     rtccTime    tm1;            // time structure
@@ -696,7 +698,6 @@ BYTE AdjustDaylightSavingTime()
 	switch(res)
 	{
 		case CDSM_NOCHANGE:
-			return 0;
 		break;
 		case CDSM_DISABLED_NOW:
 		case CDSM_ERROR_DISABLED_NOW:
@@ -715,8 +716,6 @@ BYTE AdjustDaylightSavingTime()
 			rtc_set_time(gTime.hour, gTime.min, gTime.sec, 1);
 			
 			DEBUG_puts("\n\rDaylight Saving disabled. Hours decreased.");
-			
-			return 1;
 		break;
 		
 		case CDSM_ENABLED_NOW:
@@ -737,13 +736,9 @@ BYTE AdjustDaylightSavingTime()
 			rtc_set_time(gTime.hour, gTime.min, gTime.sec, 1);
             
 			DEBUG_puts("\n\rDaylight Saving enabled. Hours increased.");
-					
-			return 2;
 		break;
 		
 	}	
-	
-	return 0;
 }	
 	
 
@@ -19,6 +19,9 @@
 #define bcd2dec(bcd)	(((((bcd)>>4) & 0x0F) * 10) + ((bcd) & 0x0F)) 
 #define dec2bcd(dec)	((((dec)/10)<<4)|((dec)%10)) 
 
+// ticks between two time checks (1 s), period of TimeKeeper_Task
+#define TIMEKEEPER_PERIOD   250
+
 
 typedef struct
 {
@@ -59,7 +62,7 @@ typedef struct TimeoutEvent_Struct
 // (C) 2023-09-09 by Daniel Porzig
 
 void TimeKeeper_Init();
-void TimeKeeper_Task(void *pvParameters, BYTE *skiprate);
+void TimeKeeper_Task(void *pvParameters, DWORD *skiprate);
 BYTE TimeKeeper_needsTimeUpdate();
 BYTE TimeKeeper_UpdateTime();
 void TimeKeeper_ForceScheduleUpdates();
@@ -84,7 +87,7 @@ BYTE GetPassedMinutesCurrent();
 #define CDSM_ERROR_DISABLED_NOW		0xF3
 #define CDSM_ERROR_ENABLED_NOW		0xF4
 
-BYTE AdjustDaylightSavingTime();
+void AdjustDaylightSavingTime();
 BYTE CheckDaylightSavingMode(BYTE BBoverride);
 BYTE GetTimeTillDaylightSwitch(WORD *timerem);
 
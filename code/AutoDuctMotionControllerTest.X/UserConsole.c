@@ -13,6 +13,7 @@
 #include <plib.h>
 #include "M24512.h"
 #include "sht3x.h"
+#include "TaskScheduler.h"
 
 
 static char CommandString[255];
@@ -33,7 +34,6 @@ typedef struct command_TD
 }command;
 
 #define MAX_PARMS       100
-#define NUM_COMMANDS    13
 char *parms[MAX_PARMS];
 
 
@@ -53,6 +53,9 @@ static void cmd_test();
 static void cmd_setupBT();
 static void cmd_mvent();
 static void cmd_sensor();
+#ifdef SCHEDULER_PROFILING
+static void cmd_profile();
+#endif
 
 // table with valid commands, function pointers and help text
 const command commands[] = {
@@ -69,9 +72,14 @@ const command commands[] = {
    {"test",      cmd_test, "activate valve test mode",""},
    {"mvent",     cmd_mvent, "activate manual venting",""},
    {"sensor",    cmd_sensor, "read and display current temperature and humidity ","sensor <>"},
+#ifdef SCHEDULER_PROFILING
+   {"profile",   cmd_profile, "display task execution time profile","profile [reset]"},
+#endif
    
 };
 
+#define NUM_COMMANDS    (sizeof(commands)/sizeof(commands[0]))
+
 
 
 
@@ -311,6 +319,9 @@ static void cmd_test()
 // configure HM-17 BLE module, program device name
 static void cmd_setupBT(void)
 {
+    // find the module and switch it to the fastest UART rate
+    Bootcode_SetupBLEBaudrate(1);
+
     UART1PrintString("AT+GAIT1");     // enable high TX gain
     Delayms(250);
     UART1PrintString("AT+GAIN1");     // open RX gain
@@ -420,6 +431,58 @@ static void cmd_sensor(void)
 
 
 
+#ifdef SCHEDULER_PROFILING
+
+// display execution times of all scheduler tasks (core timer counts -> us)
+static void cmd_profile(void)
+{
+    TaskProfileStruct prof;
+    DWORD misses;
+    WORD maxlate;
+    BYTE i, b;
+    const DWORD cnt_per_us = GetSystemClock() / 2000000ul;
+
+    if(n_parms > 0 && strcmp(parms[0], "reset") == 0)
+    {
+        Scheduler_ResetProfile();
+        DEBUG_puts("\n\rProfile cleared.");
+        return;
+    }
+
+    DEBUG_puts("\n\rtask      calls  min[us]  max[us] mean[us] overruns   misses maxlate");
+
+    for(i=0; i<SCHEDULER_MAX_NUM_TASKS; i++)
+    {
+        Scheduler_GetProfile(i, &prof);
+        if(prof.calls == 0)
+        {
+            continue;
+        }
+
+        Scheduler_GetDeadlineStats(i, &misses, &maxlate);
+
+        sprintf(txt,"\n\r%4u %10lu %8lu %8lu %8lu %8lu %8lu %7u", i, prof.calls,
+                prof.min / cnt_per_us, prof.max / cnt_per_us,
+                (DWORD)(prof.sum / prof.calls) / cnt_per_us, prof.overruns,
+                misses, maxlate);
+        DEBUG_puts(txt);
+
+        // log2 histogram, first bin up to 2^(OFFSET+1) counts
+        DEBUG_puts("\n\r     hist:");
+        for(b=0; b<SCHEDULER_PROFILE_HIST_BINS; b++)
+        {
+            sprintf(txt," %u",prof.hist[b]);
+            DEBUG_puts(txt);
+        }
+    }
+
+    DEBUG_puts("\n\r");
+}
+
+#endif
+
+
+
 // define and execute a low-level motor motion pattern
 static void cmd_motor(void)
 {
@@ -4,6 +4,7 @@
 #include <proc/p32mx150f128b.h>
 #include "ValveMotionControl.h"
 #include "LedFade.h"
+#include "EventQueue.h"
 
 
 const BYTE seq_alternate2s[] = {CMD_SET, 40, 0, CMD_PAUSE, 17,CMD_SET, 40, 1, CMD_PAUSE, 17,CMD_REPEAT, 0};
@@ -14,12 +15,18 @@ WORD pwmtable_10_motor[64];
 
 VMCTLData VMCTL;
 
+// endstop events posted by the endstop ISRs (both on priority level 2),
+// handled by ValveMotionControl_Task
+EventQueueStruct VMCTL_events;
+
+#define VMCTL_EVENT_ENDSTOP_L   1   // param1 = 1
+#define VMCTL_EVENT_ENDSTOP_H   2   // param1 = 0 if ignored (ignoreEndStopH)
+
 
 // interrupt for endstop HIGH sensor
-void __ISR(_EXTERNAL_2_VECTOR , ipl5) _ExtInt2Interrupt(void)
+// the motor is stopped right here, everything else is left to the task
+void __ISR(_EXTERNAL_2_VECTOR , ipl2) _ExtInt2Interrupt(void)
 {
-    DEBUG_puts("Upper Endstop reached.\n\r");
-    
     if(!VMCTL.ignoreEndStopH)
     {
         // Stop Motor, if currently opening valve
@@ -29,9 +36,11 @@ void __ISR(_EXTERNAL_2_VECTOR , ipl5) _ExtInt2Interrupt(void)
         // stop sequence playback
         MotorControl_StopSeq();
 
-
-        // change valve controller state machine status
-        VMCTL.state = VALVE_STATUS_AT_ENDSTOP_H;
+        EventQueue_Post(&VMCTL_events, VMCTL_EVENT_ENDSTOP_H, 1, 0);
+    }
+    else
+    {
+        EventQueue_Post(&VMCTL_events, VMCTL_EVENT_ENDSTOP_H, 0, 0);
     }
     
     IFS0bits.INT2IF = 0; // Reset respective interrupt flag  
@@ -39,11 +48,8 @@ void __ISR(_EXTERNAL_2_VECTOR , ipl5) _ExtInt2Interrupt(void)
 
 
 // interrupt for endstop LOW sensor
-void __ISR(_EXTERNAL_1_VECTOR , ipl4) _ExtInt1Interrupt(void)
+void __ISR(_EXTERNAL_1_VECTOR , ipl2) _ExtInt1Interrupt(void)
 {
-
-    DEBUG_puts("Lower Endstop reached.\n\r");
-
     // Stop Motor, if currently closing valve
     if(MotorControl_getDir() == 1)
         MotorControl_SetSpeed(0, 0);
@@ -51,14 +57,45 @@ void __ISR(_EXTERNAL_1_VECTOR , ipl4) _ExtInt1Interrupt(void)
 	// stop sequence playback
 	MotorControl_StopSeq();
 
-
-	// change valve controller state machine status
-	VMCTL.state = VALVE_STATUS_AT_ENDSTOP_L;
-
+    EventQueue_Post(&VMCTL_events, VMCTL_EVENT_ENDSTOP_L, 1, 0);
     
     IFS0bits.INT1IF = 0; // Reset respective interrupt flag  
 }
 
+// handle endstop events posted by the ISRs since the last task call. an event
+// is dropped if the valve was sent the other way before it was handled
+static void ValveMotionControl_HandleEvents()
+{
+    EventStruct ev;
+
+    while(EventQueue_Get(&VMCTL_events, &ev))
+    {
+        switch(ev.type)
+        {
+            case VMCTL_EVENT_ENDSTOP_H:
+                DEBUG_puts("Upper Endstop reached.\n\r");
+
+                if(ev.param1 && VMCTL.state != VALVE_STATUS_CLOSING)
+                {
+                    // change valve controller state machine status
+                    VMCTL.state = VALVE_STATUS_AT_ENDSTOP_H;
+                    SoftTimer_Stop(&VMCTL.timeout);
+                }
+            break;
+            case VMCTL_EVENT_ENDSTOP_L:
+                DEBUG_puts("Lower Endstop reached.\n\r");
+
+                if(VMCTL.state != VALVE_STATUS_OPENING)
+                {
+                    // change valve controller state machine status
+                    VMCTL.state = VALVE_STATUS_AT_ENDSTOP_L;
+                    SoftTimer_Stop(&VMCTL.timeout);
+                }
+            break;
+        }
+    }
+}
+
 
 
 
@@ -109,7 +146,11 @@ void MotorControl_Init()
     INTCONbits.INT2EP = 0;  // setup interrupt for falling edge
     
     
-	IPC1bits.INT1IP = 1; // Setup interrupt for desired priority
+    EventQueue_Init(&VMCTL_events);
+
+	// both endstop ISRs post to the same event queue, so they must share one
+	// priority level (no preemption among producers)
+	IPC1bits.INT1IP = 2; // Setup interrupt for desired priority
 	IPC2bits.INT2IP = 2; // Setup interrupt for desired priority
 						
 	IFS0bits.INT1IF = 0; // Clear the INT1 interrupt status flag
@@ -167,7 +208,8 @@ void MotorControl_Ramp(BYTE dir, WORD fdelay, BYTE trpm, WORD rampspeed)
 		else
 			VMCTL.MotorCTL.state = 4;		
 	}
-	VMCTL.MotorCTL.delaycnt = fdelay;
+	SoftTimer_Start(&VMCTL.MotorCTL.delaytimer, fdelay, 0, NULL);
+	VMCTL.MotorCTL.delaycnt = 0;
 	VMCTL.MotorCTL.targetrpm = trpm;
 	VMCTL.MotorCTL.rampspeed = rampspeed;
     
@@ -272,9 +314,9 @@ void MotorControl_Task()
 							loop = 0;   // do not continue with next command until fade operation complete
 						break;
 						case CMD_PAUSE:
-							// arg1 = duration (0...255), duration = arg1 * 60ms (~15sec max.)
+							// arg1 = duration (0...255), duration = arg1 * 20ms (~5sec max.)
 							VMCTL.MotorCTL.Sequence.state = 2;
-							VMCTL.MotorCTL.Sequence.counter = VMCTL.MotorCTL.Sequence.seq[VMCTL.MotorCTL.Sequence.index+1]*5;
+							SoftTimer_Start(&VMCTL.MotorCTL.Sequence.timer, VMCTL.MotorCTL.Sequence.seq[VMCTL.MotorCTL.Sequence.index+1]*5, 0, NULL);
 							VMCTL.MotorCTL.Sequence.index+=2;
 							loop = 0;   // do not continue with next command 
 						break;
@@ -318,8 +360,8 @@ void MotorControl_Task()
 
 		break;
 		case 2:
-			// wait state (task cycle time 3*4ms)
-			if(--VMCTL.MotorCTL.Sequence.counter == 0)
+			// wait state
+			if(SoftTimer_Expired(&VMCTL.MotorCTL.Sequence.timer))
 			{
 				// continue with command execution
 				VMCTL.MotorCTL.Sequence.state = 1; 
@@ -341,12 +383,10 @@ void MotorControl_Task()
 			// do nothing
 		break;
 		case 1: // Waiting to fade up
-			if(VMCTL.MotorCTL.delaycnt==0)
+			if(SoftTimer_Expired(&VMCTL.MotorCTL.delaytimer))
 			{
 				VMCTL.MotorCTL.state = 2;
 			}
-			else
-				VMCTL.MotorCTL.delaycnt--;
 		break;			
 		case 2:	// Fade Up
 			if(++VMCTL.MotorCTL.delaycnt>=VMCTL.MotorCTL.rampspeed)
@@ -361,12 +401,10 @@ void MotorControl_Task()
 			}		
 		break;
 		case 3: // Waiting to fade down
-			if(VMCTL.MotorCTL.delaycnt==0)
+			if(SoftTimer_Expired(&VMCTL.MotorCTL.delaytimer))
 			{
 				VMCTL.MotorCTL.state = 4;
 			}
-			else
-				VMCTL.MotorCTL.delaycnt--;	
 		break;		
 		case 4:	// Fade Down
 			if(++VMCTL.MotorCTL.delaycnt>=VMCTL.MotorCTL.rampspeed)
@@ -463,8 +501,11 @@ void Valve_Actuate(BYTE dir, BYTE speed, BYTE mode)
     }
 
 
-	// start timeout counter
-	VMCTL.timeout_cnt = VMCTL.s_timeout;
+	// start timeout timer, timeout = 0 disables it
+	if(VMCTL.s_timeout > 0)
+		SoftTimer_Start(&VMCTL.timeout, VMCTL.s_timeout, 0, NULL);
+	else
+		SoftTimer_Stop(&VMCTL.timeout);
 
 }
 
@@ -536,6 +577,7 @@ void Valve_Stop()
 	
 	// update state machine
 	VMCTL.state = VALVE_STATUS_STOPPED;
+	SoftTimer_Stop(&VMCTL.timeout);
 }
 
 BYTE Valve_isClosed()
@@ -549,11 +591,13 @@ BYTE Valve_isOpened()
 }
 
 
-void ValveMotionControl_Task(void *pvParameters, BYTE *skiprate)
+void ValveMotionControl_Task(void *pvParameters, DWORD *skiprate)
 {
     BYTE i;
 
 	*skiprate = 1;		// default skiprate for all states	
+
+    ValveMotionControl_HandleEvents();
 	
     // --------------------------------------------------------------------        
     // Valve Control State Machine
@@ -614,16 +658,12 @@ void ValveMotionControl_Task(void *pvParameters, BYTE *skiprate)
 		
 		case VALVE_STATUS_CLOSING:
 		
-			if(VMCTL.timeout_cnt > 0)
+			if(SoftTimer_Expired(&VMCTL.timeout))
 			{
-				VMCTL.timeout_cnt--;
-				if(VMCTL.timeout_cnt == 0)
-				{
-                    DEBUG_puts("VMCTL: Timeout\n\r"); 
+                DEBUG_puts("VMCTL: Timeout\n\r"); 
 
-					// react on timeout
-					Valve_FaultStop(VCTL_FAULT_TIMEOUT_CLOSE);
-				}
+				// react on timeout
+				Valve_FaultStop(VCTL_FAULT_TIMEOUT_CLOSE);
 			}
 					
 					
@@ -631,19 +671,15 @@ void ValveMotionControl_Task(void *pvParameters, BYTE *skiprate)
 		
 		case VALVE_STATUS_OPENING:
 
-			if(VMCTL.timeout_cnt > 0)
+			if(SoftTimer_Expired(&VMCTL.timeout))
 			{
-				VMCTL.timeout_cnt--;
-				if(VMCTL.timeout_cnt == 0)
-				{
-                    DEBUG_puts("VMCTL: Timeout\n\r"); 
+                DEBUG_puts("VMCTL: Timeout\n\r"); 
 
-					// react on timeout
-					Valve_FaultStop(VCTL_FAULT_TIMEOUT_OPEN);
-                    
-                    // reset ignore endstop flag in case it was set
-                    VMCTL.ignoreEndStopH = 0;
-				}
+				// react on timeout
+				Valve_FaultStop(VCTL_FAULT_TIMEOUT_OPEN);
+                
+                // reset ignore endstop flag in case it was set
+                VMCTL.ignoreEndStopH = 0;
 			}
 		
 		
@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include "HardwareProfile.h"
 #include <GenericTypeDefs.h>
+#include "SoftTimer.h"
 
 
 void MotorControl_Init();
@@ -23,7 +24,7 @@ BYTE MotorControl_getDir();
 typedef struct MotorCTLSequence_Struct
 {
 	BYTE state;
-	WORD counter;
+	SoftTimerStruct timer;  // pause timer
     BYTE index;
     BYTE seq[1000];
     BYTE repcnt;
@@ -36,7 +37,8 @@ typedef struct MotorCTL_Struct
     BYTE dir;
 	BYTE rpm, targetrpm;
 	WORD rampspeed;
-	WORD delaycnt;
+	WORD delaycnt;          // ramp step counter
+	SoftTimerStruct delaytimer; // ramp start delay
     MotorCTLSequenceData Sequence;
 }MotorCTLData;	
 
@@ -48,7 +50,7 @@ typedef struct VMCTL_Struct
     BYTE faultcode;			// last fault code
 	
 	WORD maxcurr;			// maximum current measured during last run
-	WORD timeout_cnt;		// timeout counter
+	SoftTimerStruct timeout;	// motion timeout
 	
     BYTE ignoreEndStopH;    // special test mode flag -> eject valve
 	
@@ -115,7 +117,7 @@ void MotorControl_SoftShutdown();
 
 
 void ValveMotionControl_Init();
-void ValveMotionControl_Task(void *pvParameters, BYTE *skiprate);
+void ValveMotionControl_Task(void *pvParameters, DWORD *skiprate);
 void Valve_FaultStop(BYTE faultcode);
 void Valve_Stop();
 void Valve_Close(BYTE speed, BYTE mode);
@@ -57,17 +57,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=UserConsole.c LEDFade.c sht3x.c AutoDuctTestMain.c ValveMotionControl.c FanControl.c DeviceControl.c TimeKeeper.c Config.c BTComCallbacksApp.c RTC_RV3129.c ../Common/BTCom.c ../Common/CircBuffer.c ../Common/Delay.c ../Common/M24512.c ../Common/NVMem.c ../Common/TaskScheduler.c ../Common/uart1.c ../Common/uart2.c
+SOURCEFILES_QUOTED_IF_SPACED=UserConsole.c LEDFade.c sht3x.c AutoDuctTestMain.c ValveMotionControl.c FanControl.c DeviceControl.c TimeKeeper.c Config.c BTComCallbacksApp.c RTC_RV3129.c ../Common/BTCom.c ../Common/BTComDecoder.c ../Common/CircBuffer.c ../Common/CRC16.c ../Common/Delay.c ../Common/M24512.c ../Common/NVMem.c ../Common/TaskScheduler.c ../Common/SoftTimer.c ../Common/EventQueue.c ../Common/UartDMA.c ../Common/Log.c ../Common/uart1.c ../Common/uart2.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/UserConsole.o ${OBJECTDIR}/LEDFade.o ${OBJECTDIR}/sht3x.o ${OBJECTDIR}/AutoDuctTestMain.o ${OBJECTDIR}/ValveMotionControl.o ${OBJECTDIR}/FanControl.o ${OBJECTDIR}/DeviceControl.o ${OBJECTDIR}/TimeKeeper.o ${OBJECTDIR}/Config.o ${OBJECTDIR}/BTComCallbacksApp.o ${OBJECTDIR}/RTC_RV3129.o ${OBJECTDIR}/_ext/2108356922/BTCom.o ${OBJECTDIR}/_ext/2108356922/CircBuffer.o ${OBJECTDIR}/_ext/2108356922/Delay.o ${OBJECTDIR}/_ext/2108356922/M24512.o ${OBJECTDIR}/_ext/2108356922/NVMem.o ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o ${OBJECTDIR}/_ext/2108356922/uart1.o ${OBJECTDIR}/_ext/2108356922/uart2.o
-POSSIBLE_DEPFILES=${OBJECTDIR}/UserConsole.o.d ${OBJECTDIR}/LEDFade.o.d ${OBJECTDIR}/sht3x.o.d ${OBJECTDIR}/AutoDuctTestMain.o.d ${OBJECTDIR}/ValveMotionControl.o.d ${OBJECTDIR}/FanControl.o.d ${OBJECTDIR}/DeviceControl.o.d ${OBJECTDIR}/TimeKeeper.o.d ${OBJECTDIR}/Config.o.d ${OBJECTDIR}/BTComCallbacksApp.o.d ${OBJECTDIR}/RTC_RV3129.o.d ${OBJECTDIR}/_ext/2108356922/BTCom.o.d ${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d ${OBJECTDIR}/_ext/2108356922/Delay.o.d ${OBJECTDIR}/_ext/2108356922/M24512.o.d ${OBJECTDIR}/_ext/2108356922/NVMem.o.d ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d ${OBJECTDIR}/_ext/2108356922/uart1.o.d ${OBJECTDIR}/_ext/2108356922/uart2.o.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/UserConsole.o ${OBJECTDIR}/LEDFade.o ${OBJECTDIR}/sht3x.o ${OBJECTDIR}/AutoDuctTestMain.o ${OBJECTDIR}/ValveMotionControl.o ${OBJECTDIR}/FanControl.o ${OBJECTDIR}/DeviceControl.o ${OBJECTDIR}/TimeKeeper.o ${OBJECTDIR}/Config.o ${OBJECTDIR}/BTComCallbacksApp.o ${OBJECTDIR}/RTC_RV3129.o ${OBJECTDIR}/_ext/2108356922/BTCom.o ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o ${OBJECTDIR}/_ext/2108356922/CircBuffer.o ${OBJECTDIR}/_ext/2108356922/CRC16.o ${OBJECTDIR}/_ext/2108356922/Delay.o ${OBJECTDIR}/_ext/2108356922/M24512.o ${OBJECTDIR}/_ext/2108356922/NVMem.o ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o ${OBJECTDIR}/_ext/2108356922/SoftTimer.o ${OBJECTDIR}/_ext/2108356922/EventQueue.o ${OBJECTDIR}/_ext/2108356922/UartDMA.o ${OBJECTDIR}/_ext/2108356922/Log.o ${OBJECTDIR}/_ext/2108356922/uart1.o ${OBJECTDIR}/_ext/2108356922/uart2.o
+POSSIBLE_DEPFILES=${OBJECTDIR}/UserConsole.o.d ${OBJECTDIR}/LEDFade.o.d ${OBJECTDIR}/sht3x.o.d ${OBJECTDIR}/AutoDuctTestMain.o.d ${OBJECTDIR}/ValveMotionControl.o.d ${OBJECTDIR}/FanControl.o.d ${OBJECTDIR}/DeviceControl.o.d ${OBJECTDIR}/TimeKeeper.o.d ${OBJECTDIR}/Config.o.d ${OBJECTDIR}/BTComCallbacksApp.o.d ${OBJECTDIR}/RTC_RV3129.o.d ${OBJECTDIR}/_ext/2108356922/BTCom.o.d ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o.d ${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d ${OBJECTDIR}/_ext/2108356922/CRC16.o.d ${OBJECTDIR}/_ext/2108356922/Delay.o.d ${OBJECTDIR}/_ext/2108356922/M24512.o.d ${OBJECTDIR}/_ext/2108356922/NVMem.o.d ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d ${OBJECTDIR}/_ext/2108356922/SoftTimer.o.d ${OBJECTDIR}/_ext/2108356922/EventQueue.o.d ${OBJECTDIR}/_ext/2108356922/UartDMA.o.d ${OBJECTDIR}/_ext/2108356922/Log.o.d ${OBJECTDIR}/_ext/2108356922/uart1.o.d ${OBJECTDIR}/_ext/2108356922/uart2.o.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/UserConsole.o ${OBJECTDIR}/LEDFade.o ${OBJECTDIR}/sht3x.o ${OBJECTDIR}/AutoDuctTestMain.o ${OBJECTDIR}/ValveMotionControl.o ${OBJECTDIR}/FanControl.o ${OBJECTDIR}/DeviceControl.o ${OBJECTDIR}/TimeKeeper.o ${OBJECTDIR}/Config.o ${OBJECTDIR}/BTComCallbacksApp.o ${OBJECTDIR}/RTC_RV3129.o ${OBJECTDIR}/_ext/2108356922/BTCom.o ${OBJECTDIR}/_ext/2108356922/CircBuffer.o ${OBJECTDIR}/_ext/2108356922/Delay.o ${OBJECTDIR}/_ext/2108356922/M24512.o ${OBJECTDIR}/_ext/2108356922/NVMem.o ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o ${OBJECTDIR}/_ext/2108356922/uart1.o ${OBJECTDIR}/_ext/2108356922/uart2.o
+OBJECTFILES=${OBJECTDIR}/UserConsole.o ${OBJECTDIR}/LEDFade.o ${OBJECTDIR}/sht3x.o ${OBJECTDIR}/AutoDuctTestMain.o ${OBJECTDIR}/ValveMotionControl.o ${OBJECTDIR}/FanControl.o ${OBJECTDIR}/DeviceControl.o ${OBJECTDIR}/TimeKeeper.o ${OBJECTDIR}/Config.o ${OBJECTDIR}/BTComCallbacksApp.o ${OBJECTDIR}/RTC_RV3129.o ${OBJECTDIR}/_ext/2108356922/BTCom.o ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o ${OBJECTDIR}/_ext/2108356922/CircBuffer.o ${OBJECTDIR}/_ext/2108356922/CRC16.o ${OBJECTDIR}/_ext/2108356922/Delay.o ${OBJECTDIR}/_ext/2108356922/M24512.o ${OBJECTDIR}/_ext/2108356922/NVMem.o ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o ${OBJECTDIR}/_ext/2108356922/SoftTimer.o ${OBJECTDIR}/_ext/2108356922/EventQueue.o ${OBJECTDIR}/_ext/2108356922/UartDMA.o ${OBJECTDIR}/_ext/2108356922/Log.o ${OBJECTDIR}/_ext/2108356922/uart1.o ${OBJECTDIR}/_ext/2108356922/uart2.o
 
 # Source Files
-SOURCEFILES=UserConsole.c LEDFade.c sht3x.c AutoDuctTestMain.c ValveMotionControl.c FanControl.c DeviceControl.c TimeKeeper.c Config.c BTComCallbacksApp.c RTC_RV3129.c ../Common/BTCom.c ../Common/CircBuffer.c ../Common/Delay.c ../Common/M24512.c ../Common/NVMem.c ../Common/TaskScheduler.c ../Common/uart1.c ../Common/uart2.c
+SOURCEFILES=UserConsole.c LEDFade.c sht3x.c AutoDuctTestMain.c ValveMotionControl.c FanControl.c DeviceControl.c TimeKeeper.c Config.c BTComCallbacksApp.c RTC_RV3129.c ../Common/BTCom.c ../Common/BTComDecoder.c ../Common/CircBuffer.c ../Common/CRC16.c ../Common/Delay.c ../Common/M24512.c ../Common/NVMem.c ../Common/TaskScheduler.c ../Common/SoftTimer.c ../Common/EventQueue.c ../Common/UartDMA.c ../Common/Log.c ../Common/uart1.c ../Common/uart2.c
 
 
 
@@ -179,12 +179,24 @@ ${OBJECTDIR}/_ext/2108356922/BTCom.o: ../Common/BTCom.c  nbproject/Makefile-${CN
 	@${RM} ${OBJECTDIR}/_ext/2108356922/BTCom.o 
 	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/BTCom.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/BTCom.o.d" -o ${OBJECTDIR}/_ext/2108356922/BTCom.o ../Common/BTCom.c  
 	
+${OBJECTDIR}/_ext/2108356922/BTComDecoder.o: ../Common/BTComDecoder.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/BTComDecoder.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/BTComDecoder.o.d" -o ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o ../Common/BTComDecoder.c  
+	
 ${OBJECTDIR}/_ext/2108356922/CircBuffer.o: ../Common/CircBuffer.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/CircBuffer.o 
 	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d" -o ${OBJECTDIR}/_ext/2108356922/CircBuffer.o ../Common/CircBuffer.c  
 	
+${OBJECTDIR}/_ext/2108356922/CRC16.o: ../Common/CRC16.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/CRC16.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/CRC16.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/CRC16.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/CRC16.o.d" -o ${OBJECTDIR}/_ext/2108356922/CRC16.o ../Common/CRC16.c  
+	
 ${OBJECTDIR}/_ext/2108356922/Delay.o: ../Common/Delay.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/Delay.o.d 
@@ -209,6 +221,30 @@ ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o: ../Common/TaskScheduler.c  nbproje
 	@${RM} ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o 
 	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d" -o ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o ../Common/TaskScheduler.c  
 	
+${OBJECTDIR}/_ext/2108356922/SoftTimer.o: ../Common/SoftTimer.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/SoftTimer.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/SoftTimer.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/SoftTimer.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/SoftTimer.o.d" -o ${OBJECTDIR}/_ext/2108356922/SoftTimer.o ../Common/SoftTimer.c  
+	
+${OBJECTDIR}/_ext/2108356922/EventQueue.o: ../Common/EventQueue.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/EventQueue.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/EventQueue.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/EventQueue.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/EventQueue.o.d" -o ${OBJECTDIR}/_ext/2108356922/EventQueue.o ../Common/EventQueue.c  
+	
+${OBJECTDIR}/_ext/2108356922/UartDMA.o: ../Common/UartDMA.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/UartDMA.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/UartDMA.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/UartDMA.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/UartDMA.o.d" -o ${OBJECTDIR}/_ext/2108356922/UartDMA.o ../Common/UartDMA.c  
+	
+${OBJECTDIR}/_ext/2108356922/Log.o: ../Common/Log.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/Log.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/Log.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/Log.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/Log.o.d" -o ${OBJECTDIR}/_ext/2108356922/Log.o ../Common/Log.c  
+	
 ${OBJECTDIR}/_ext/2108356922/uart1.o: ../Common/uart1.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/uart1.o.d 
@@ -294,12 +330,24 @@ ${OBJECTDIR}/_ext/2108356922/BTCom.o: ../Common/BTCom.c  nbproject/Makefile-${CN
 	@${RM} ${OBJECTDIR}/_ext/2108356922/BTCom.o 
 	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/BTCom.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/BTCom.o.d" -o ${OBJECTDIR}/_ext/2108356922/BTCom.o ../Common/BTCom.c  
 	
+${OBJECTDIR}/_ext/2108356922/BTComDecoder.o: ../Common/BTComDecoder.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/BTComDecoder.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/BTComDecoder.o.d" -o ${OBJECTDIR}/_ext/2108356922/BTComDecoder.o ../Common/BTComDecoder.c  
+	
 ${OBJECTDIR}/_ext/2108356922/CircBuffer.o: ../Common/CircBuffer.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/CircBuffer.o 
 	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/CircBuffer.o.d" -o ${OBJECTDIR}/_ext/2108356922/CircBuffer.o ../Common/CircBuffer.c  
 	
+${OBJECTDIR}/_ext/2108356922/CRC16.o: ../Common/CRC16.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/CRC16.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/CRC16.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/CRC16.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/CRC16.o.d" -o ${OBJECTDIR}/_ext/2108356922/CRC16.o ../Common/CRC16.c  
+	
 ${OBJECTDIR}/_ext/2108356922/Delay.o: ../Common/Delay.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/Delay.o.d 
@@ -324,6 +372,30 @@ ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o: ../Common/TaskScheduler.c  nbproje
 	@${RM} ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o 
 	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/TaskScheduler.o.d" -o ${OBJECTDIR}/_ext/2108356922/TaskScheduler.o ../Common/TaskScheduler.c  
 	
+${OBJECTDIR}/_ext/2108356922/SoftTimer.o: ../Common/SoftTimer.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/SoftTimer.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/SoftTimer.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/SoftTimer.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/SoftTimer.o.d" -o ${OBJECTDIR}/_ext/2108356922/SoftTimer.o ../Common/SoftTimer.c  
+	
+${OBJECTDIR}/_ext/2108356922/EventQueue.o: ../Common/EventQueue.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/EventQueue.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/EventQueue.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/EventQueue.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/EventQueue.o.d" -o ${OBJECTDIR}/_ext/2108356922/EventQueue.o ../Common/EventQueue.c  
+	
+${OBJECTDIR}/_ext/2108356922/UartDMA.o: ../Common/UartDMA.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/UartDMA.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/UartDMA.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/UartDMA.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/UartDMA.o.d" -o ${OBJECTDIR}/_ext/2108356922/UartDMA.o ../Common/UartDMA.c  
+	
+${OBJECTDIR}/_ext/2108356922/Log.o: ../Common/Log.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/Log.o.d 
+	@${RM} ${OBJECTDIR}/_ext/2108356922/Log.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/2108356922/Log.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION) -I"../../../microchip_solutions_v2013-06-15/Microchip/Include" -I"." -I"../Common" -Os -MMD -MF "${OBJECTDIR}/_ext/2108356922/Log.o.d" -o ${OBJECTDIR}/_ext/2108356922/Log.o ../Common/Log.c  
+	
 ${OBJECTDIR}/_ext/2108356922/uart1.o: ../Common/uart1.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/_ext/2108356922" 
 	@${RM} ${OBJECTDIR}/_ext/2108356922/uart1.o.d 
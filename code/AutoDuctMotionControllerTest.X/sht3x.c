@@ -670,16 +670,26 @@ etError SHT3X_SoftReset(void)
 {
   etError error; // error code
 
+  error = SHT3X_StartSoftReset();
+  
+  // if no error, wait 50 ms afloater reset
+  if(error == NO_ERROR)
+      Delayms(SHT3X_SOFTRESET_TIME_MS); 
+
+  return error;
+}
+
+//-----------------------------------------------------------------------------
+etError SHT3X_StartSoftReset(void)
+{
+  etError error; // error code
+
   error = SHT3X_StartWriteAccess();
 
   // write reset command
   error |= SHT3X_WriteCommand(CMD_SOFT_RESET);
 
   SHT3X_StopAccess();
-  
-  // if no error, wait 50 ms afloater reset
-  if(error == NO_ERROR)
-      Delayms(50); 
 
   return error;
 }
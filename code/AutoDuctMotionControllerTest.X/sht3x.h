@@ -337,6 +337,17 @@ BYTE SHT3X_ReadAlert(void);
 //-----------------------------------------------------------------------------
 etError SHT3X_SoftReset(void);
 
+//-----------------------------------------------------------------------------
+// Sends the soft reset command without waiting for the sensor to restart.
+// The caller has to wait at least SHT3X_SOFTRESET_TIME_MS before the next access.
+//-----------------------------------------------------------------------------
+// return: error:       ACK_ERROR      = no acknowledgment from sensor
+//                      NO_ERROR       = no error
+//-----------------------------------------------------------------------------
+#define SHT3X_SOFTRESET_TIME_MS     50
+
+etError SHT3X_StartSoftReset(void);
+
 
 //=============================================================================
 // Resets the sensor by pulling down the reset pin.
@@ -3,28 +3,28 @@
 
 #include "BTCom.h"
 #include "UART1.h"
+#include "SoftTimer.h"
+#include "UartDMA.h"
+#include "Log.h"
+#include "CRC16.h"
+#include "BTComDecoder.h"
+#include <string.h>
+#include <plib.h>
 
 
-#define MAX_PACKET_SIZE         256
+#define COMREC_ERROR_TIMEOUT            5       // timeout occured before complete package was received
 
-#define COMREC_STATE_IDLE       0
-#define COMREC_STATE_STARTSEQ   1
-#define COMREC_STATE_DATADEC    2
-#define COMREC_STATE_NEXTISDATA 3
+#define TIMEOUT_TICKS   SOFTTIMER_SEC(2)    // receive timeout between two bytes
 
-#define COMREC_DECODE_DONE              1       // decoding done
-#define COMREC_ERROR_CHECKSUM           2       // checksum error
-#define COMREC_ERROR_MAX_PACKETSIZE     3       // max. packet size exceeded
-#define COMREC_ERROR_TIMEOUT            4       // timeout occured before complete package was received
-#define COMREC_ERROR_SYNTAX             5       // syntax error, unexpected data received
+// transmit frame encoder states
+#define BTCOM_ENC_STX1          0
+#define BTCOM_ENC_STX2          1
+#define BTCOM_ENC_DATA          2
+#define BTCOM_ENC_TRAILER       3
+#define BTCOM_ENC_ETX           4
+#define BTCOM_ENC_DONE          5
 
-//Communications Control bytes
-#define STX             0x55
-#define ETX             0x04
-#define DLE             0x05
-
-
-#define TIMEOUT_CNT     500     // approx 2 second counter    
+#define BTCOM_TX_CHUNK          32      // encoded bytes per DMA block
 
 
 #define _VERBOSE_
@@ -32,338 +32,1070 @@
 
 
 WORD responseBytes;                                                                 //Number of bytes in command response
-BYTE buffer[MAX_PACKET_SIZE+1];                                                     //Transmit/Recieve Buffer
-BYTE checksum;
+BYTE buffer[MAX_PACKET_SIZE+5];                                                     //Command/Transmit Buffer
 WORD dataCount;
 
-BYTE comRecState = 0;       // status of command receiver
-WORD comRecTimeout = TIMEOUT_CNT;   
+// queue of received frames, decoded while a response is sent
+#define BTCOM_RX_FRAMES         BTCOM_V2_WINDOW
 
-CommandStruct BTcoms[BTCOM_MAX_NUMBER_COMMANDS];
-BYTE numComsUsed;
+typedef struct
+{
+    WORD len;           // decoded bytes
+    BYTE version;
+    BYTE status;        // BTCOM_ACK or NAK to send
+    DWORD rxtime;       // core timer at the end of the frame
+    BYTE data[MAX_PACKET_SIZE+5];
+}BTComFrameStruct;
+
+static BTComFrameStruct rxframes[BTCOM_RX_FRAMES];
+static BYTE rxhead, rxtail;     // free running, rxhead - rxtail frames queued
+static BTComDecoderStruct rxdec;    // decodes into the next free frame slot
+
+static BYTE comVersion = 1;     // protocol version of the current command
+static BYTE comSeq;             // v2 sequence number of the current command
+static BYTE *comPayload = buffer;   // command / response of the current frame
+static BYTE nakframe[2];            // seq, status
+static WORD comCrc;             // v2 request CRC of the current command
+
+// responses to the last v2 requests. a request repeated with the same seq and
+// CRC (its response was lost) is answered from here, the command does not run
+// a second time
+typedef struct
+{
+    WORD len;           // response frame length (seq status payload), 0: unused
+    WORD crc;           // request CRC
+    BYTE data[MAX_PACKET_SIZE+2];
+}BTComReplayStruct;
+
+static BTComReplayStruct replay[BTCOM_V2_WINDOW];
+static BYTE replayNext;         // slot of the next response
+
+// HM-17 connection messages, received outside of frames
+#define BTCOM_LINK_MSG_LEN      7
+static const char linkConnMsg[] = "OK+CONN";
+static const char linkLostMsg[] = "OK+LOST";
+static char linkLine[BTCOM_LINK_MSG_LEN];  // last bytes outside of frames
+static BTComLinkCallback linkCallback;
+#ifdef BTCOM_STREAMING
+static BYTE notifyframe[BTCOM_NOTIFY_MAX+2];
+#endif
 
+#ifdef BTCOM_STREAMING
+typedef struct
+{
+    BTComStreamProducer producer;   // NULL: no stream active
+    void *ctx;
+    DWORD offset;       // next stream byte
+    WORD crc;           // CRC16 of bytes 0..offset-1
+    BYTE cmd;
+    BYTE credits;       // data frames the host accepts
+    SoftTimerStruct timer;
+}BTComStreamStruct;
+#endif
 
-static char txt[60];
+#ifdef BTCOM_STREAMING
+static BTComStreamStruct stream;
+static BYTE streamframe[2 + 7 + BTCOM_STREAM_CHUNK];    // v2 header, stream header, data
+#endif
+
+#ifdef BTCOM_BATCH
+static BYTE batchreq[MAX_PACKET_SIZE+1];    // copy of the batch request
+static BYTE batchsub[MAX_PACKET_SIZE+1];    // sub-command / response
+#endif
+
+SoftTimerStruct comRecTimer;    // receive timeout, restarted on every byte
+
+static BYTE comCmdStatus;       // BTCOM_ACK or reason the command was rejected
+
+#ifdef BTCOM_DIAG
+// per command statistics (see BTCOM_CMD_DIAG), core timer counts
+typedef struct
+{
+    DWORD calls;
+    DWORD rejected;     // request length invalid
+    UINT64 cycles;      // handler execution time
+    DWORD cyclesMax;
+    UINT64 latency;     // end of request until the response was sent
+    DWORD latencyMax;
+    BYTE cmd;
+}BTComCmdStatsStruct;
+#endif
 
+// frame errors
+typedef struct
+{
+    DWORD checksum;
+    DWORD timeout;
+    DWORD oversize;
+    DWORD syntax;
+}BTComErrorStatsStruct;
+
+static BTComErrorStatsStruct errstats;
+#ifdef BTCOM_DIAG
+static BTComCmdStatsStruct cmdstats[BTCOM_STATS_CMDS];
+static BYTE cmdstatsCount;
+static BTComCmdStatsStruct * volatile txstats;  // response pending, latency not taken yet
+static DWORD txrxtime;                          // end of its request
+#endif
+
+
+static char txt[60];
 
-static void SendFWStringBT(BYTE *outbuf, WORD *len);
-void BTCom_defaultCallback(BYTE *buf_in, BYTE *buf_out, BYTE* len);
+typedef struct
+{
+    BYTE *data;         // unencoded response
+    WORD len;
+    WORD i;             // next data byte
+    BYTE checksum;
+    WORD crc;
+    BYTE version;
+    BYTE trailer[2];    // checksum (v1) or CRC (v2)
+    BYTE ntrailer;
+    BYTE t;             // next trailer byte
+    BYTE state;
+    BYTE stuffed;       // DLE of the current byte already sent
+}BTComEncoderStruct;
+
+static BTComEncoderStruct encoder;
+static BYTE txchunk[BTCOM_TX_CHUNK];
+
+
+static void BTCom_StartFrame(BYTE *data, WORD len, BYTE version, UartDMACallback done);
+static void BTCom_PutNak(BYTE status);
+static void BTCom_FrameDone(BYTE status);
+static void BTCom_DispatchFrame();
+static BYTE BTCom_Replay();
+static void BTCom_ScanLink(BYTE *data, WORD n);
+static const CommandStruct *BTCom_FindCommand(BYTE id);
+#ifdef BTCOM_STREAMING
+static void BTCom_StreamTask();
+#endif
+#ifdef BTCOM_DIAG
+static void BTCom_ResponseSent();
+static BTComCmdStatsStruct *BTCom_CmdStats(BYTE cmd, BYTE add);
+#define BTCOM_RESPONSE_SENT     BTCom_ResponseSent  // takes the latency
+#else
+#define BTCOM_RESPONSE_SENT     NULL
+#endif
 
 // initialize protocol handler
 void BTCom_Init()
 {
-    BYTE i;
-    checksum = 0;
+    WORD i;
+
     dataCount = 0;
-    comRecState = 0;
-    
-    for(i=0; i<BTCOM_MAX_NUMBER_COMMANDS; i++)
+    BTComDecoder_Init(&rxdec, rxframes[0].data, sizeof(rxframes[0].data));
+    rxhead = 0;
+    rxtail = 0;
+#ifdef BTCOM_STREAMING
+    stream.producer = NULL;
+#endif
+    BTCom_ClearReplay();
+    memset(linkLine, 0, sizeof(linkLine));
+
+    // the binary search misses commands of an unsorted registry: a build
+    // error, halt in both firmwares (the bootloader has no log)
+    for(i=1; i<BTCom_commandCount; i++)
+    {
+        if(BTCom_commands[i].id <= BTCom_commands[i-1].id)
+        {
+            DEBUG_puts("BTCOM: command registry not sorted by ID\n\r");
+            UartDMA_Flush(UARTDMA_UART2);
+
+            while(1)
+            {
+                asm("nop");
+            }
+        }
+    }
+}
+
+// forget the cached responses, the next request runs in any case
+// (new connection, the host may start over with any seq)
+void BTCom_ClearReplay()
+{
+    BYTE i;
+
+    for(i=0; i<BTCOM_V2_WINDOW; i++)
     {
-        BTcoms[i].CmdID = 0xFF;
-        BTcoms[i].callback = NULL;
+        replay[i].len = 0;
     }
-    numComsUsed = 0;
 }
 
-// add a command including callback to protocol handler
-void BTCom_addCallback(BYTE CmdID, VoidFnctCallback callback)
+// called on BLE connect / disconnect
+void BTCom_SetLinkCallback(BTComLinkCallback cb)
 {
-    if(numComsUsed == BTCOM_MAX_NUMBER_COMMANDS)
-        return;
-    
-    BTcoms[numComsUsed].CmdID = CmdID;
-    BTcoms[numComsUsed].callback = callback;
-    numComsUsed++;
+    linkCallback = cb;
+}
+
+// look for "OK+CONN" / "OK+LOST" in the bytes before the next STX (the
+// decoder ignores them). a new or lost connection ends the session: cached
+// responses and the stream are dropped, the host starts over
+static void BTCom_ScanLink(BYTE *data, WORD n)
+{
+    WORD i;
+
+    for(i=0; i<n && data[i] != STX; i++)
+    {
+        memmove(linkLine, &linkLine[1], BTCOM_LINK_MSG_LEN-1);
+        linkLine[BTCOM_LINK_MSG_LEN-1] = data[i];
+
+        if(memcmp(linkLine, linkConnMsg, BTCOM_LINK_MSG_LEN) == 0 ||
+           memcmp(linkLine, linkLostMsg, BTCOM_LINK_MSG_LEN) == 0)
+        {
+            LOG1(LOG_MOD_BTCOM, LOG_LEVEL_INFO, "BTCOM: link %c\n\r", linkLine[3]);
+            memset(linkLine, 0, sizeof(linkLine));
+            BTCom_ClearReplay();
+#ifdef BTCOM_STREAMING
+            stream.producer = NULL;
+#endif
+            if(linkCallback != NULL)
+            {
+                linkCallback();
+            }
+        }
+    }
 }
 
 // protocol handler task
 BYTE BTCom_Task()
 {
-    BYTE RXByte;
-    BYTE status = 0;
+    BYTE status;
+    BYTE result = 0;
+    BYTE *rx;
+    WORD n, used;
     
 
-    // check user inputs
-    while(!UART1_BufIsEmpty())
+    // check user inputs, parsed in place from the receive buffer.
+    // decoding continues while a response is sent, complete frames are queued
+    n = UART1_BufReadSpan(&rx);
+    if(n > 0)
     {
-        RXByte=UART1_BufRead();
-        comRecTimeout = TIMEOUT_CNT; // reset timeout counter
-  
-        
-//        sprintf(txt,"%02X,",RXByte);
-//        UART3PrintString(txt);        
-        
-        switch(comRecState)
-        {
-            case COMREC_STATE_IDLE:     // Idle
-                
-                if(RXByte == STX)
-                {
-                    // first STX received, wait for second STX
-                    comRecState = COMREC_STATE_STARTSEQ;
-
-                }
-                else
-                {
-                    //status = COMREC_ERROR_SYNTAX;   // error, unexpected data received
-                    ;       // unexpected data received, ignore.
-                }
+        SoftTimer_Start(&comRecTimer, TIMEOUT_TICKS, 0, NULL); // reset timeout
+    }
 
-            break;
-            case COMREC_STATE_STARTSEQ:     // active sequence, first STX received, wait for second STX
+    while(n > 0)
+    {
+        if(rxdec.state == BTCOMDEC_STATE_IDLE)
+        {
+            // all frame slots in use: keep the remaining bytes in the UART buffer
+            if((BYTE)(rxhead - rxtail) == BTCOM_RX_FRAMES)
+            {
+                break;
+            }
 
-                if(RXByte == STX)
-                {
-                    // second STX received, following bytes are data
-                    comRecState = COMREC_STATE_DATADEC;
+            // bytes up to the next frame: HM-17 connection messages
+            BTCom_ScanLink(rx, n);
 
-                    dataCount = 0;
-                    checksum = 0;
-                    
-                    // DEBUG: start sequence
-#ifdef _VERBOSE_
-                    DEBUG_puts("\r\n<[");
-#endif
-                }
-                else
-                {
-                    status = COMREC_ERROR_SYNTAX;   // error, unexpected data received
-                }
-                
-            break;
-            case COMREC_STATE_DATADEC:     // active sequence, store incoming data into buffer
-                
-				switch(RXByte)
-                {
-					case STX: //Start over if STX
-						checksum = 0;
-						dataCount = 0;
-                        
-                        // DEBUG: start sequence
-#ifdef _VERBOSE_                        
-                        DEBUG_puts("\r\n<[");                        
-#endif
-                    break;
+            // decode into the next free frame slot
+            rxdec.buf = rxframes[rxhead % BTCOM_RX_FRAMES].data;
+            rxdec.size = sizeof(rxframes[0].data);
+        }
 
-					case ETX: //End of packet if ETX
-                        
-                        //Test checksum
-						checksum = ~checksum + 1;                                   
-						                        
-						if(checksum == 0) 
-                        {
-                            // checksum okay, continue with Command Decoding
-                            status = COMREC_DECODE_DONE;
-#ifdef _VERBOSE_                            
-                            DEBUG_puts("] OK\n\r");
-#endif                            
-                        }
-                        else
-                        {
-                            // checksum error.
-                            status = COMREC_ERROR_CHECKSUM;
-                            dataCount = 0xFFFF;                                         //Otherwise restart                            
-                            
-                            
-                        }
-					break;
-
-					case DLE: //If DLE, treat next as data
-                        
-                        // signal receiver state machine that next byte is
-                        // to be treated as data
-                        comRecState = COMREC_STATE_NEXTISDATA;
-                        
-                    break;
-					default: // regular data byte
-						checksum += RXByte;
-						buffer[dataCount++] = RXByte;
+        used = BTComDecoder_Feed(&rxdec, rx, n, &status);
+        UART1_BufReadCommit(used);
 
-#ifdef _VERBOSE_                        
-                        sprintf(txt,"%02X",RXByte);
-                        DEBUG_puts(txt);
-#endif
-                        
-                        if(dataCount <= MAX_PACKET_SIZE+1)
-                        {
-                            ; // everything ok
-                        }
-                        else
-                        {
-                            // max. packet size exceeded
-                            status = COMREC_ERROR_MAX_PACKETSIZE;
-                        }
-					break;        
-                }
-                
-            break;
-            case COMREC_STATE_NEXTISDATA:     // active sequence, treat current byte as data without inspection
-                
-                // treat as regular data byte
-                checksum += RXByte;
-                buffer[dataCount++] = RXByte;
-
-#ifdef _VERBOSE_                
-                sprintf(txt,"%02X",RXByte);
-                DEBUG_puts(txt);
-#endif
-                
-                
-                // set state machine back to default decoding mode
-                comRecState = COMREC_STATE_DATADEC;                
-                
-                if(dataCount <= MAX_PACKET_SIZE+1)
-                {
-                    ; // everything ok
-                }
-                else
-                {
-                    // max. packet size exceeded
-                    status = COMREC_ERROR_MAX_PACKETSIZE;
-                }
-                
-            break;            
-        }
-    
-        
-        if(status > 0)
+        if(status != BTCOMDEC_NONE)
         {
-            // leave receiving loop upon error or completed packet
-            break;
+            // queue completed frame (or NAK), continue with the next one
+            BTCom_FrameDone(status);
+            result = status;
         }
+
+        // continue with the rest, or the part behind the buffer wrap-around
+        n = UART1_BufReadSpan(&rx);
+    }
+
+    // check if operation timed out before a complete packet was received
+    if(rxdec.state != BTCOMDEC_STATE_IDLE && SoftTimer_Expired(&comRecTimer))
+    {
+        BTCom_FrameDone(COMREC_ERROR_TIMEOUT);
+        result = COMREC_ERROR_TIMEOUT;
     }
 
+    // answer the queued frames once the last response is out
+    BTCom_IdleTask();
     
+#ifdef BTCOM_STREAMING
+    // send next stream frame, if no response went out
+    BTCom_StreamTask();
+#endif
 
-    if(status == 0)
+    return result;
+}
+
+// answer queued frames back to back: a frame is dispatched as soon as the
+// transmitter is idle, frames without response (v1 NAK) do not wait.
+// call from the scheduler idle task, so the next response does not wait for
+// the next tick. returns 1 while frames wait for the transmitter
+BYTE BTCom_IdleTask()
+{
+    while(rxhead != rxtail && !UartDMA_IsBusy(UARTDMA_UART1))
     {
-        // check if operation timed out before a complete packet was received
-        if(comRecState > 0)
-        {
-            if(--comRecTimeout == 0)
-            {
-                status = COMREC_ERROR_TIMEOUT;   // set timeout error
-            }
-        }
-        
+        BTCom_DispatchFrame();
     }
-   
-    // handle status code
-    switch(status)
+
+    return (rxhead != rxtail);
+}
+
+// frame decoding finished: queue the frame, v2 errors are queued as NAK
+static void BTCom_FrameDone(BYTE status)
+{
+    BTComFrameStruct *f = &rxframes[rxhead % BTCOM_RX_FRAMES];
+    BYTE inframe = BTComDecoder_InFrame(&rxdec);
+    BYTE version = rxdec.version;       // the reset below clears them
+    WORD count = rxdec.count;
+
+    // a timed out frame is dropped, the decoder starts over
+    if(status == COMREC_ERROR_TIMEOUT)
     {
-        case COMREC_DECODE_DONE:
-            // reset receiver state machine
-            comRecState = COMREC_STATE_IDLE;
+        BTComDecoder_Reset(&rxdec);
+    }
 
-            // decode received package
-            BTCom_HandleCommand(buffer,buffer,dataCount);
-            
-            // send response
-            BTCom_PutResponse();            
+    f->rxtime = ReadCoreTimer();
 
-#ifdef _VERBOSE_            
-            // send response to debug console
-            BTCom_PutResponseDebug();
+    switch(status)
+    {
+        case BTCOMDEC_DONE:
+            f->status = BTCOM_ACK;
+#ifdef _VERBOSE_
+            LOG2(LOG_MOD_BTCOM, LOG_LEVEL_DEBUG, "\r\n<v%u %u bytes> OK\n\r", version, count);
 #endif
         break;
         
-        case COMREC_ERROR_MAX_PACKETSIZE:
-             DEBUG_puts("COMREC_ERROR_MAX_PACKETSIZE\n\r");
-            
-            // do not send a response so host will resend package
-            comRecState = COMREC_STATE_IDLE;           
-            
+        case BTCOMDEC_ERR_SIZE:
+            LOG(LOG_MOD_BTCOM, LOG_LEVEL_WARN, "COMREC_ERROR_MAX_PACKETSIZE\n\r");
+            errstats.oversize++;
+            f->status = BTCOM_NAK_LENGTH;
         break;
         
-        case COMREC_ERROR_CHECKSUM:
-            DEBUG_puts("COMREC_ERROR_CHECKSUM\n\r");
-            comRecState = COMREC_STATE_IDLE;
-            // do not send a response so host will resend package
-            
+        case BTCOMDEC_ERR_CHECKSUM:
+            LOG(LOG_MOD_BTCOM, LOG_LEVEL_WARN, "COMREC_ERROR_CHECKSUM\n\r");
+            errstats.checksum++;
+            f->status = BTCOM_NAK_CRC;
         break;
         
         case COMREC_ERROR_TIMEOUT:
-            DEBUG_puts("COMREC_ERROR_TIMEOUT\n\r");
-            comRecState = COMREC_STATE_IDLE;
-            // do not send a response so host will resend package
-            
+            LOG(LOG_MOD_BTCOM, LOG_LEVEL_WARN, "COMREC_ERROR_TIMEOUT\n\r");
+            if(inframe)
+            {
+                errstats.timeout++;
+            }
+            f->status = BTCOM_NAK_TIMEOUT;
         break;
-        
+
         default:
-            // nothing to do
+            LOG(LOG_MOD_BTCOM, LOG_LEVEL_WARN, "COMREC_ERROR_SYNTAX\n\r");
+            errstats.syntax++;
+            f->status = BTCOM_NAK_SYNTAX;
         break;
     }
+
+    // v1: do not send a response on errors so host will resend package.
+    // no frame slot is taken before the second start byte
+    if((status == COMREC_ERROR_TIMEOUT && !inframe) ||
+       (f->status != BTCOM_ACK && version != 2))
+    {
+        return;
+    }
+
+    f->len = count;
+    f->version = version;
+    rxhead++;
+}
+
+// execute the oldest queued command and start its response
+static void BTCom_DispatchFrame()
+{
+    BTComFrameStruct *f;
+#ifdef BTCOM_DIAG
+    DWORD rxtime;
+    BYTE cmd;
+#endif
+
+    if(rxhead == rxtail)
+    {
+        return;
+    }
+
+    // commands are executed in the transmit buffer, the slot is free again
+    f = &rxframes[rxtail % BTCOM_RX_FRAMES];
+    comVersion = f->version;
+    dataCount = f->len;
+    memcpy(buffer, f->data, f->len);
+#ifdef BTCOM_DIAG
+    rxtime = f->rxtime;
+#endif
+    rxtail++;
+
+    if(f->status != BTCOM_ACK)
+    {
+        BTCom_PutNak(f->status);
+        return;
+    }
+
+    if(comVersion == 2)
+    {
+        // command behind reserved byte and seq, response is built in place
+        comPayload = &buffer[2];
+        comSeq = buffer[1];
+        comCrc = ((WORD)buffer[dataCount-2] << 8) | buffer[dataCount-1];
+        dataCount -= 3;     // like v1: command, data and one trailer byte
+
+        if(BTCom_Replay())
+        {
+            return;
+        }
+    }
+    else
+    {
+        comPayload = buffer;
+    }
+
+    LOG2(LOG_MOD_BTCOM, LOG_LEVEL_INFO, "\r\nBTCOM: command %02X, %u bytes\n\r", comPayload[0], dataCount);
+
+    // decode received package
+#ifdef BTCOM_DIAG
+    cmd = comPayload[0];
+#endif
+    BTCom_HandleCommand(comPayload,comPayload,dataCount);
     
+    if(comCmdStatus != BTCOM_ACK)
+    {
+        // request rejected, v1: do not send a response
+        BTCom_PutNak(comCmdStatus);
+        return;
+    }
 
-    return status;
+    // send response, its latency is taken when the last byte went out
+    UartDMA_Flush(UARTDMA_UART1);
+#ifdef BTCOM_DIAG
+    txrxtime = rxtime;
+    txstats = BTCom_CmdStats(cmd, 0);
+#endif
+    BTCom_PutResponse();            
+
+#ifdef _VERBOSE_            
+    // send response to debug console
+    if(LOG_ENABLED(LOG_MOD_BTCOM, LOG_LEVEL_DEBUG))
+    {
+        BTCom_PutResponseDebug();
+    }
+#endif
+}
+
+
+// answer a repeated v2 request with its cached response, returns 0 if the
+// request is new
+static BYTE BTCom_Replay()
+{
+    BTComReplayStruct *r;
+    BYTE i;
+
+    for(i=0; i<BTCOM_V2_WINDOW; i++)
+    {
+        r = &replay[i];
+        if(r->len != 0 && r->data[0] == comSeq && r->crc == comCrc)
+        {
+            LOG1(LOG_MOD_BTCOM, LOG_LEVEL_INFO, "\r\nBTCOM: seq %u repeated, response replayed\n\r", comSeq);
+            BTCom_StartFrame(r->data, r->len, 2, NULL);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+#ifdef BTCOM_DIAG
+// statistics of a command, a free slot is assigned if <add> is set.
+// returns NULL if there is none
+static BTComCmdStatsStruct *BTCom_CmdStats(BYTE cmd, BYTE add)
+{
+    BTComCmdStatsStruct *stats;
+    BYTE i;
+
+    for(i=0; i<cmdstatsCount; i++)
+    {
+        if(cmdstats[i].cmd == cmd)
+        {
+            return &cmdstats[i];
+        }
+    }
+
+    if(!add || cmdstatsCount == BTCOM_STATS_CMDS)
+    {
+        return NULL;
+    }
+
+    stats = &cmdstats[cmdstatsCount++];
+    memset(stats, 0, sizeof(BTComCmdStatsStruct));
+    stats->cmd = cmd;
+
+    return stats;
 }
+#endif
+
+// registry entry of a command, NULL if it has none
+static const CommandStruct *BTCom_FindCommand(BYTE id)
+{
+    WORD lo = 0;
+    WORD hi = BTCom_commandCount;
+    WORD mid;
+
+    while(lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if(BTCom_commands[mid].id == id)
+        {
+            return &BTCom_commands[mid];
+        }
+        if(BTCom_commands[mid].id < id)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
 
+    return NULL;
+}
+
+#ifdef BTCOM_BATCH
+// longest response of a command with request length <len> (+1),
+// echoed commands return the request
+static WORD BTCom_ResponseMax(BYTE *buf_in, WORD len)
+{
+    const CommandStruct *cmd = BTCom_FindCommand(buf_in[0]);
+
+    return (cmd != NULL && cmd->respMax != BTCOM_LEN_ECHO) ? cmd->respMax : len - 1;
+}
+#endif
+
+// check the request length and execute the callback of a command,
+// <len> is replaced by the response length
+static BYTE BTCom_Dispatch(BYTE *buf_in, BYTE *buf_out, WORD *len)
+{
+    const CommandStruct *cmd = BTCom_FindCommand(buf_in[0]);
+    VoidFnctCallback callback;
+    WORD reqlen = *len - 1;     // without trailer byte
+#ifdef BTCOM_DIAG
+    BTComCmdStatsStruct *stats = NULL;
+    DWORD cycles;
+
+    // slots for registered commands only, echoed IDs would use them up
+    if(cmd != NULL)
+    {
+        stats = BTCom_CmdStats(cmd->id, 1);
+    }
+#endif
+
+    if(cmd == NULL)
+    {
+        // execute default callback, if command not recognized
+        callback = BTCom_defaultCallback;
+    }
+    else if(reqlen < cmd->reqMin || reqlen > cmd->reqMax)
+    {
+        LOG2(LOG_MOD_BTCOM, LOG_LEVEL_WARN, "BTCOM: command %02X rejected, %u bytes\n\r", buf_in[0], reqlen);
+#ifdef BTCOM_DIAG
+        if(stats != NULL)
+        {
+            stats->rejected++;
+        }
+#endif
+        return BTCOM_NAK_REQUEST;
+    }
+    else
+    {
+        callback = cmd->callback;
+    }
+
+    // execute callback
+#ifdef BTCOM_DIAG
+    cycles = ReadCoreTimer();
+    callback(buf_in, buf_out, len);
+    cycles = ReadCoreTimer() - cycles;
+
+    if(stats != NULL)
+    {
+        stats->calls++;
+        stats->cycles += cycles;
+        if(cycles > stats->cyclesMax)
+        {
+            stats->cyclesMax = cycles;
+        }
+    }
+#else
+    callback(buf_in, buf_out, len);
+#endif
+
+    if(cmd != NULL && *len > ((cmd->respMax != BTCOM_LEN_ECHO) ? cmd->respMax : reqlen))
+    {
+        LOG2(LOG_MOD_BTCOM, LOG_LEVEL_ERROR, "BTCOM: command %02X response too long, %u bytes\n\r", buf_in[0], *len);
+    }
+
+    return BTCOM_ACK;
+}
 
 // interprete command and execute callback
 WORD BTCom_HandleCommand(BYTE *buf_in, BYTE *buf_out, WORD len)
 {
-	BYTE Command, j, match;
     // len = packet length (including checksum byte!!!)
 
-	Command = buf_in[0];  //Get command from buffer
 //	length = buf_in[1];   //Get data length from buffer
 
 //    responseBytes = 1;    // set response length to 1 byte default
     responseBytes = len;
 
-    match = 0;
-    for(j=0; j<numComsUsed; j++)
+    comCmdStatus = BTCom_Dispatch(buf_in, buf_out, &responseBytes);
+    
+    return responseBytes;
+}
+
+#ifdef BTCOM_BATCH
+// run the sub-commands of a batch request, responses are length-prefixed
+void BTCom_batchCallback(BYTE *buf_in, BYTE *buf_out, WORD *len)
+{
+    WORD reqlen, in, out, sublen;
+    BYTE count = 0;
+    BYTE status = BTCOM_BATCH_OK;
+
+    // request and response share the buffer
+    reqlen = *len - 1;      // without trailer byte
+    memcpy(batchreq, buf_in, reqlen);
+
+    in = 1;
+    out = 3;
+    while(in < reqlen)
     {
-        if(BTcoms[j].CmdID == Command)
+        sublen = batchreq[in];
+        if(sublen == 0 || in + 1 + sublen > reqlen)
+        {
+            status = BTCOM_BATCH_SYNTAX;
+            break;
+        }
+
+        if(batchreq[in+1] == BTCOM_CMD_BATCH || batchreq[in+1] >= 0xF0)
+        {
+            status = BTCOM_BATCH_REFUSED;
+            break;
+        }
+
+        // execute like a single command (length includes a trailer byte)
+        memcpy(batchsub, &batchreq[in+1], sublen);
+        in += 1 + sublen;
+        sublen++;
+
+        // stop before running a command whose response might not fit
+        if(out + 1 + BTCom_ResponseMax(batchsub, sublen) > MAX_PACKET_SIZE)
+        {
+            status = BTCOM_BATCH_OVERFLOW;
+            break;
+        }
+
+        if(BTCom_Dispatch(batchsub, batchsub, &sublen) != BTCOM_ACK || sublen > 255)
         {
-            // execute callback
-            BTcoms[j].callback(buf_in, buf_out, &responseBytes);
-            match = 1;
+            status = BTCOM_BATCH_SYNTAX;
+            break;
         }
+
+        buf_out[out] = sublen;
+        memcpy(&buf_out[out+1], batchsub, sublen);
+        out += 1 + sublen;
+        count++;
     }
-    
-    // execute default callback, if command not recognized
-    if(match == 0)
+
+    buf_out[0] = BTCOM_CMD_BATCH;
+    buf_out[1] = status;
+    buf_out[2] = count;
+
+    *len = out;
+}
+#endif
+
+
+#ifdef BTCOM_DIAG
+// append a DWORD, MSB first
+static BYTE *BTCom_PutDWord(BYTE *p, DWORD val)
+{
+    *p++ = val >> 24;
+    *p++ = val >> 16;
+    *p++ = val >> 8;
+    *p++ = val;
+    return p;
+}
+
+static BYTE *BTCom_PutQWord(BYTE *p, UINT64 val)
+{
+    p = BTCom_PutDWord(p, (DWORD)(val >> 32));
+    return BTCom_PutDWord(p, (DWORD)val);
+}
+
+// read diagnostic counters (see BTCOM_CMD_DIAG)
+void BTCom_diagCallback(BYTE *buf_in, BYTE *buf_out, WORD *len)
+{
+    BTComCmdStatsStruct *stats;
+    BTComCmdStatsStruct copy;
+    BYTE *p = &buf_out[2];
+    BYTE i;
+    unsigned int int_status;
+
+    buf_out[0] = BTCOM_CMD_DIAG;
+    buf_out[1] = buf_in[1];
+
+    switch(buf_in[1])
     {
-        BTCom_defaultCallback(buf_in, buf_out, &responseBytes);
+        case BTCOM_DIAG_GLOBAL:
+            p = BTCom_PutDWord(p, errstats.checksum);
+            p = BTCom_PutDWord(p, errstats.timeout);
+            p = BTCom_PutDWord(p, errstats.oversize);
+            p = BTCom_PutDWord(p, errstats.syntax);
+            p = BTCom_PutDWord(p, UART1_GetRxOverruns());
+            p = BTCom_PutDWord(p, UART1_GetRxDropped());
+            *p++ = cmdstatsCount;
+            for(i=0; i<cmdstatsCount; i++)
+            {
+                *p++ = cmdstats[i].cmd;
+            }
+        break;
+
+        case BTCOM_DIAG_COMMAND:
+            if(*len - 1 < 3)
+            {
+                break;      // command ID missing, echo type only
+            }
+            *p++ = buf_in[2];
+            stats = BTCom_CmdStats(buf_in[2], 0);
+            if(stats == NULL)
+            {
+                // not called yet
+                memset(&copy, 0, sizeof(copy));
+            }
+            else
+            {
+                // the latency is added in the DMA interrupt, 64 bit
+                int_status = INTDisableInterrupts();
+                copy = *stats;
+                INTRestoreInterrupts(int_status);
+            }
+            p = BTCom_PutDWord(p, copy.calls);
+            p = BTCom_PutDWord(p, copy.rejected);
+            p = BTCom_PutQWord(p, copy.cycles);
+            p = BTCom_PutDWord(p, copy.cyclesMax);
+            p = BTCom_PutQWord(p, copy.latency);
+            p = BTCom_PutDWord(p, copy.latencyMax);
+        break;
+
+        case BTCOM_DIAG_RESET:
+            // a pending latency would go to a cleared slot
+            txstats = NULL;
+            cmdstatsCount = 0;
+            memset(&errstats, 0, sizeof(errstats));
+            UART1_ClearRxErrors();
+        break;
     }
-    
-    return responseBytes;
+
+    *len = p - buf_out;
+}
+#endif
+
+
+#ifdef BTCOM_STREAMING
+// start a streaming response, <params> = offset(4) crc(2) credits(1) of the
+// request. a running stream is replaced (resume)
+void BTCom_StartStream(BYTE cmd, BYTE *params, BTComStreamProducer producer, void *ctx)
+{
+    stream.cmd = cmd;
+    stream.offset = ((DWORD)params[0] << 24) | ((DWORD)params[1] << 16) | ((DWORD)params[2] << 8) | params[3];
+    stream.crc = ((WORD)params[4] << 8) | params[5];
+    stream.credits = params[6];
+    stream.ctx = ctx;
+    stream.producer = producer;
+
+    SoftTimer_Start(&stream.timer, BTCOM_STREAM_TIMEOUT, 0, NULL);
+}
+
+// stream flow control from the host
+void BTCom_streamCallback(BYTE *buf_in, BYTE *buf_out, WORD *len)
+{
+    // buf_in[0] = CMD
+    // buf_in[1] = operation
+    // buf_in[2] = credits (BTCOM_STREAM_CREDIT)
+
+    if(buf_in[1] == BTCOM_STREAM_CREDIT && *len > 3)
+    {
+        if(stream.credits + buf_in[2] > 255)
+        {
+            stream.credits = 255;
+        }
+        else
+        {
+            stream.credits += buf_in[2];
+        }
+        SoftTimer_Start(&stream.timer, BTCOM_STREAM_TIMEOUT, 0, NULL);
+    }
+    else if(buf_in[1] == BTCOM_STREAM_ABORT)
+    {
+        stream.producer = NULL;
+    }
+
+    // response: CMD, operation, credits left (0 if no stream is active)
+    buf_out[2] = (stream.producer != NULL) ? stream.credits : 0;
+    *len = 3;
+}
+
+// send the next frame of the active stream
+static void BTCom_StreamTask()
+{
+    BYTE *p = &streamframe[2];
+    WORD n;
+
+    if(stream.producer == NULL || UartDMA_IsBusy(UARTDMA_UART1))
+    {
+        return;
+    }
+
+    if(stream.credits == 0)
+    {
+        if(SoftTimer_Expired(&stream.timer))
+        {
+            // host is gone, it resumes from its last offset
+            LOG1(LOG_MOD_BTCOM, LOG_LEVEL_WARN, "BTCOM: stream %02X timeout\n\r", stream.cmd);
+            stream.producer = NULL;
+        }
+        return;
+    }
+
+    n = stream.producer(stream.ctx, stream.offset, &p[7], BTCOM_STREAM_CHUNK);
+
+    p[0] = BTCOM_CMD_STREAM;
+    p[1] = stream.cmd;
+    p[2] = (n > 0) ? BTCOM_STREAM_DATA : BTCOM_STREAM_END;
+    p[3] = stream.offset >> 24;
+    p[4] = stream.offset >> 16;
+    p[5] = stream.offset >> 8;
+    p[6] = stream.offset & 0xFF;
+
+    if(n > 0)
+    {
+        stream.crc = CRC16_Update(stream.crc, &p[7], n);
+        stream.offset += n;
+        stream.credits--;
+        SoftTimer_Start(&stream.timer, BTCOM_STREAM_TIMEOUT, 0, NULL);
+    }
+    else
+    {
+        // end of stream: total length and CRC
+        p[7] = stream.crc >> 8;
+        p[8] = stream.crc & 0xFF;
+        n = 2;
+        stream.producer = NULL;
+    }
+
+    if(comVersion == 2)
+    {
+        streamframe[0] = 0;
+        streamframe[1] = BTCOM_NOTIFY;
+        BTCom_StartFrame(streamframe, 2 + 7 + n, 2, NULL);
+    }
+    else
+    {
+        BTCom_StartFrame(p, 7 + n, 1, NULL);
+    }
+}
+#endif
+
+
+// streaming frame encoder, fills the next chunk of the transmit frame
+// (DMA source, called from the DMA interrupt)
+static WORD BTCom_EncoderSource(void *ctx, BYTE **block)
+{
+    BTComEncoderStruct *enc = (BTComEncoderStruct*)ctx;
+    WORD n = 0;
+    BYTE data;
+
+    while(n < BTCOM_TX_CHUNK && enc->state != BTCOM_ENC_DONE)
+    {
+        switch(enc->state)
+        {
+            case BTCOM_ENC_STX1:
+                txchunk[n++] = STX;                                                 //Put start sequence
+                enc->state = BTCOM_ENC_STX2;
+            break;
+
+            case BTCOM_ENC_STX2:
+                txchunk[n++] = (enc->version == 2) ? STX2 : STX;
+                enc->state = BTCOM_ENC_DATA;
+            break;
+
+            case BTCOM_ENC_DATA:
+            case BTCOM_ENC_TRAILER:
+                if(enc->state == BTCOM_ENC_DATA)
+                {
+                    if(enc->i == enc->len)
+                    {
+                        if(enc->version == 2)
+                        {
+                            enc->trailer[0] = enc->crc >> 8;
+                            enc->trailer[1] = enc->crc & 0xFF;
+                            enc->ntrailer = 2;
+                        }
+                        else
+                        {
+                            enc->trailer[0] = ~enc->checksum + 1;
+                            enc->ntrailer = 1;
+                        }
+                        enc->t = 0;
+                        enc->state = BTCOM_ENC_TRAILER;
+                        break;
+                    }
+                    data = enc->data[enc->i];
+                }
+                else
+                {
+                    data = enc->trailer[enc->t];
+                }
+
+                if((data == STX || data == ETX || data == DLE) && !enc->stuffed)
+                {
+                    //If control character, stuff DLE
+                    txchunk[n++] = DLE;
+                    enc->stuffed = 1;
+                    break;
+                }
+
+                txchunk[n++] = data;
+                enc->stuffed = 0;
+
+                if(enc->state == BTCOM_ENC_DATA)
+                {
+                    enc->checksum += data;                                          //Accumulate checksum
+                    enc->crc = CRC16_UpdateByte(enc->crc, data);
+                    enc->i++;
+                }
+                else if(++enc->t == enc->ntrailer)
+                {
+                    enc->state = BTCOM_ENC_ETX;
+                }
+            break;
+
+            case BTCOM_ENC_ETX:
+                txchunk[n++] = ETX;                                                 //Put End of text
+                enc->state = BTCOM_ENC_DONE;
+            break;
+        }
+    }
+
+    *block = txchunk;
+    return n;
 }
 
+// start the frame transmission (by DMA, returns before the transmission is finished)
+static void BTCom_StartFrame(BYTE *data, WORD len, BYTE version, UartDMACallback done)
+{
+    // the last response must be out before the encoder is reused
+    UartDMA_Flush(UARTDMA_UART1);
+
+    encoder.data = data;
+    encoder.len = len;
+    encoder.i = 0;
+    encoder.checksum = 0;
+    encoder.crc = CRC16_INIT;
+    encoder.version = version;
+    encoder.stuffed = 0;
+    encoder.state = BTCOM_ENC_STX1;
+
+    UartDMA_Start(UARTDMA_UART1, BTCom_EncoderSource, &encoder, done);
+}
+
+#ifdef BTCOM_DIAG
+// last response byte handed to the UART (DMA interrupt): take the latency
+static void BTCom_ResponseSent()
+{
+    BTComCmdStatsStruct *stats = txstats;
+    DWORD latency;
+
+    if(stats == NULL)
+    {
+        return;
+    }
+
+    latency = ReadCoreTimer() - txrxtime;
+    stats->latency += latency;
+    if(latency > stats->latencyMax)
+    {
+        stats->latencyMax = latency;
+    }
+    txstats = NULL;
+}
+#endif
 
-// transmit response
+// transmit response in the protocol version of the request
 void BTCom_PutResponse()
 {
-	WORD i;
-	BYTE data;
-	BYTE checksum;
+    if(comVersion == 2)
+    {
+        buffer[0] = comSeq;
+        buffer[1] = BTCOM_ACK;
+        BTCom_StartFrame(buffer, responseBytes + 2, 2, BTCOM_RESPONSE_SENT);
 
-	UART1PutChar(STX);                                                                   //Put 2 STX characters
-	UART1PutChar(STX);
-    
+        // keep it for a repeated request, the oldest response is replaced
+        if(responseBytes + 2 <= sizeof(replay[0].data))
+        {
+            replay[replayNext].len = responseBytes + 2;
+            replay[replayNext].crc = comCrc;
+            memcpy(replay[replayNext].data, buffer, responseBytes + 2);
+            replayNext = (replayNext + 1) % BTCOM_V2_WINDOW;
+        }
+    }
+    else
+    {
+        BTCom_StartFrame(buffer, responseBytes, 1, BTCOM_RESPONSE_SENT);
+    }
+}
 
-	checksum = 0;
-	for(i = 0; i < responseBytes; i++)
+#ifdef BTCOM_STREAMING
+// send an unsolicited frame (in the protocol version of the last request),
+// returns 0 if the transmitter is busy
+BYTE BTCom_PutNotification(BYTE *data, WORD len)
+{
+    if(UartDMA_IsBusy(UARTDMA_UART1) || len > BTCOM_NOTIFY_MAX)
     {
-		data = buffer[i];                                                           //Get data from response buffer
-		checksum += data;                                                           //Accumulate checksum
-		if(data == STX || data == ETX || data == DLE)
-        {                         		//If control character, stuff DLE
-            UART1PutChar(DLE);
-		}
-        UART1PutChar(data);                                                              //Send data
-	}
+        return 0;
+    }
 
-	checksum = ~checksum + 1;                                                       //Keep track of checksum
-	if(checksum == STX || checksum == ETX || checksum == DLE)
-    {                      //If control character, stuff DLE
-        UART1PutChar(DLE);
-	}
+    if(comVersion == 2)
+    {
+        notifyframe[0] = 0;
+        notifyframe[1] = BTCOM_NOTIFY;
+        memcpy(&notifyframe[2], data, len);
+        BTCom_StartFrame(notifyframe, len + 2, 2, NULL);
+    }
+    else
+    {
+        memcpy(notifyframe, data, len);
+        BTCom_StartFrame(notifyframe, len, 1, NULL);
+    }
 
-	UART1PutChar(checksum);                                                              //Put checksum
-	UART1PutChar(ETX);                                                                   //Put End of text
+    return 1;
+}
+#endif
 
+// reject the current v2 frame, v1 frames are not answered on errors
+static void BTCom_PutNak(BYTE status)
+{
+    if(comVersion != 2)
+    {
+        return;
+    }
+
+    UartDMA_Flush(UARTDMA_UART1);
+
+    nakframe[0] = (dataCount >= 2) ? buffer[1] : 0xFF;     // seq, if received
+    nakframe[1] = status;
+    BTCom_StartFrame(nakframe, 2, 2, NULL);
 }
 
 
@@ -387,7 +1119,7 @@ void BTCom_PutResponseDebug()
 	for(i = 0; i < responseBytes; i++)
     {
 		// asm("clrwdt");                                                              //Looping code so clear WDT
-		data = buffer[i];                                                           //Get data from response buffer
+		data = comPayload[i];                                                       //Get data from response buffer
 		checksum += data;                                                           //Accumulate checksum
 		if(data == STX || data == ETX || data == DLE)
         {                         		//If control character, stuff DLE
@@ -479,184 +1211,67 @@ BYTE hexStrToByte(char* string)
 //    + input string does not contain <DLE> encoding, but <STX>,<ETX> and checksum
 BYTE BTCom_injectCommand(char *str)
 {
-    BYTE len,i,RXByte,status = 0;
-    WORD respbytes;
-    char *pstr;
-//    char txt[20];
+    BTComDecoderStruct dec;     // own decoder state, a BLE frame may be in progress
+    WORD len, n;
+    BYTE status = BTCOMDEC_NONE;
+    BYTE b;
     
-    pstr=str;
-    
-    // reset command decoding state machine
-    comRecState = COMREC_STATE_IDLE;
-
-    len = strlen(str);
+    // buffer is shared with the response transmission
+    UartDMA_Flush(UARTDMA_UART1);
 
-    i = 0;
-    
     DEBUG_puts(str);
-    
-    // check user inputs
-    while(i<len)
-    {
-        
-        // convert input hex string into raw data byte
-        RXByte = hexStrToByte(str + i);
-        i+=2;
-                
-        //UART2_putc(RXByte);
-        
-//        sprintf(txt," %02X,",RXByte);
-//        UART2_puts(txt);        
-    
-        switch(comRecState)
-        {
-            case COMREC_STATE_IDLE:     // Idle
-                
-                if(RXByte == STX)
-                {
-                    // first STX received, wait for second STX
-                    comRecState = COMREC_STATE_STARTSEQ;
-                }
-                else
-                {
-                    ;   // error, unexpected data received. ignore.
-                }
-
-            break;
-            case COMREC_STATE_STARTSEQ:     // active sequence, first STX received, wait for second STX
-
-                if(RXByte == STX)
-                {
-                    // second STX received, following bytes are data
-                    comRecState = COMREC_STATE_DATADEC;
-                    dataCount = 0;
-                    checksum = 0;
-                    
-                    // DEBUG: start sequence
-                    DEBUG_puts("[");
-                }
-                else
-                {
-                    ;   // error, unexpected data received
-                }
-                
-            break;
-            case COMREC_STATE_DATADEC:     // active sequence, store incoming data into buffer
-                
-				switch(RXByte)
-                {
-					case STX: //Start over if STX
-						checksum = 0;
-						dataCount = 0;
-                        
-                        // DEBUG: start sequence
-                        DEBUG_puts("[");                       
-                    break;
 
-					case ETX: //End of packet if ETX
-                        
-                        //Test checksum
-						checksum = ~checksum + 1;                                   
-						                        
-						if(checksum == 0) 
-                        {
-                            // checksum okay, continue with Command Decoding
-                            status = COMREC_DECODE_DONE;
-                            
-                            DEBUG_puts("] OK\n\r");
-                        }
-                        else
-                        {
-                            // checksum error.
-                            status = COMREC_ERROR_CHECKSUM;
-                            dataCount = 0xFFFF;                                         //Otherwise restart                            
-                            
-                            DEBUG_puts("] Checksum error\n\r");
-                        }
-					break;
-
-					case DLE: //If DLE, treat next as data
-                        
-                        // signal receiver state machine that next byte is
-                        // to be treated as data
-                        comRecState = COMREC_STATE_NEXTISDATA;
-                        
-                    break;
-					default: // regular data byte
-						checksum += RXByte;
-						buffer[dataCount++] = RXByte;
-                        
-                        sprintf(txt,"%02X",RXByte);
-                        DEBUG_puts(txt);
-                        
-                        if(dataCount <= MAX_PACKET_SIZE+1)
-                        {
-                            ; // everything ok
-                        }
-                        else
-                        {
-                            // max. packet size exceeded
-                            status = COMREC_ERROR_MAX_PACKETSIZE;
-                        }
-					break;        
-                }
-                
-            break;
-            case COMREC_STATE_NEXTISDATA:     // active sequence, treat current byte as data without inspection
-                
-                // treat as regular data byte
-                checksum += RXByte;
-                buffer[dataCount++] = RXByte;
-
-                sprintf(txt,"%02X",RXByte);
-                DEBUG_puts(txt);
-                
-                
-                // set state machine back to default decoding mode
-                comRecState = COMREC_STATE_DATADEC;                
-                
-                if(dataCount <= MAX_PACKET_SIZE+1)
-                {
-                    ; // everything ok
-                }
-                else
-                {
-                    // max. packet size exceeded
-                    status = COMREC_ERROR_MAX_PACKETSIZE;
-                }
-                
-            break;            
-        }
-    
-        
-        if(status > 0)
-        {
-            // leave receiving loop upon error or completed package
-            break;
-        }
+    // decode the first frame of the input hex string, byte by byte
+    len = strlen(str) / 2;
+    BTComDecoder_Init(&dec, buffer, sizeof(buffer));
+    for(n = 0; n < len && status == BTCOMDEC_NONE; n++)
+    {
+        b = hexStrToByte(str + 2*n);
+        BTComDecoder_Feed(&dec, &b, 1, &status);
     }
 
- 
     // handle status code
     switch(status)
     {
-        case COMREC_DECODE_DONE:
-            // reset receiver state machine
-            comRecState = COMREC_STATE_IDLE;
+        case BTCOMDEC_DONE:
+            sprintf(txt,"[v%u %u bytes] OK\n\r", dec.version, dec.count);
+            DEBUG_puts(txt);
+
+            comVersion = dec.version;
+            dataCount = dec.count;
+            if(comVersion == 2)
+            {
+                // command behind reserved byte and seq
+                comPayload = &buffer[2];
+                comSeq = buffer[1];
+                dataCount -= 3;
+            }
+            else
+            {
+                comPayload = buffer;
+            }
 
             // decode received package
-            BTCom_HandleCommand(buffer,buffer,dataCount);
+            BTCom_HandleCommand(comPayload,comPayload,dataCount);
             
+            if(comCmdStatus != BTCOM_ACK)
+            {
+                DEBUG_puts("Request length invalid\n\r");
+                break;
+            }
+
             // send response
             BTCom_PutResponseDebug();
         break;
+
+        case BTCOMDEC_ERR_CHECKSUM:
+            DEBUG_puts("Checksum error\n\r");
+        break;
+
         default:
             // handle error
         break;
     }
-    
 
-    
+    return status;
 }
-
-
@@ -20,27 +20,171 @@ typedef union _FLOAT_VAL
 
 
 
-// maximum number of commands
-#define BTCOM_MAX_NUMBER_COMMANDS		30
-
-
-typedef void (*VoidFnctCallback)( BYTE*, BYTE*, BYTE *);
-
-
-
+#define MAX_PACKET_SIZE         256
+
+
+// protocol v2 frame (v1 frames <STX><STX>data<checksum><ETX> are still accepted):
+//   request:  <STX><STX2> seq cmd data... crc_hi crc_lo <ETX>
+//   response: <STX><STX2> seq status [cmd data...] crc_hi crc_lo <ETX>
+// CRC16 (CCITT-FALSE) over seq..data, DLE stuffing as in v1.
+// The host may send up to BTCOM_V2_WINDOW requests without waiting for the
+// responses, they are decoded into a frame queue while a response is sent
+// and answered in order (further frames wait in the UART receive buffer).
+// The responses to the last BTCOM_V2_WINDOW requests are kept: a request
+// repeated with the same seq and CRC is answered again without running the
+// command twice, so the host must use a new seq for every new request.
+#define BTCOM_V2_WINDOW         4
+
+// v2 response status, a NAK carries no payload
+#define BTCOM_ACK               0x00
+#define BTCOM_NAK_CRC           0x01    // CRC mismatch
+#define BTCOM_NAK_LENGTH        0x02    // max. packet size exceeded
+#define BTCOM_NAK_TIMEOUT       0x03    // frame incomplete
+#define BTCOM_NAK_SYNTAX        0x04    // frame too short
+#define BTCOM_NAK_REQUEST       0x05    // request length invalid for the command
+#define BTCOM_NOTIFY            0x80    // unsolicited frame (seq 0), not a response
+
+#define BTCOM_NOTIFY_MAX        32      // max. notification length
+
+
+// protocol extensions of the app, left out of the bootloader (size)
+#ifndef _BOOTLOADER_
+#define BTCOM_BATCH             // CMD_BATCH
+#define BTCOM_STREAMING         // CMD_STREAM, notifications
+#define BTCOM_DIAG              // CMD_DIAG, per command statistics
+#endif
+
+
+// batch command, runs several commands in one frame:
+//   request:  CMD_BATCH {len cmd data...}...
+//   response: CMD_BATCH status count {len response...}...
+// count sub-responses are returned, on error sub-command <count> failed
+// (on overflow it was not executed).
+// Device commands (0xF0..0xFF) and nested batches are refused.
+#define BTCOM_CMD_BATCH         0xFA
+
+#define BTCOM_BATCH_OK          0x00
+#define BTCOM_BATCH_OVERFLOW    0x01    // response might exceed the packet size
+#define BTCOM_BATCH_SYNTAX      0x02    // sub-command length invalid
+#define BTCOM_BATCH_REFUSED     0x03    // command not allowed in a batch
+
+
+// streaming responses for bulk data. A command handler starts a stream with
+// BTCom_StartStream(), the device then sends unsolicited frames
+//   CMD_STREAM cmd BTCOM_STREAM_DATA offset(4) data...
+//   CMD_STREAM cmd BTCOM_STREAM_END  length(4) crc(2)
+// filled on demand by the producer. Every data frame uses one credit, the
+// host grants credits with CMD_STREAM BTCOM_STREAM_CREDIT n. The CRC16 runs
+// over the whole stream: streaming requests carry offset(4) crc(2) credits(1),
+// a host resuming after a dropped link passes its CRC of bytes 0..offset-1
+// (CRC16_INIT at offset 0).
+#define BTCOM_CMD_STREAM        0xF9
+
+#define BTCOM_STREAM_DATA       0x00
+#define BTCOM_STREAM_END        0x01
+#define BTCOM_STREAM_CREDIT     0x00    // host: grant n more data frames
+#define BTCOM_STREAM_ABORT      0x01    // host: stop the stream
+
+#define BTCOM_STREAM_PARAMS     7       // offset, crc, credits of a streaming request
+#define BTCOM_STREAM_CHUNK      128     // max. data bytes per frame
+#define BTCOM_STREAM_TIMEOUT    SOFTTIMER_SEC(10)   // abort when no credit is granted
+
+// diagnostics, counters since power-up (or the last reset):
+//   CMD_DIAG BTCOM_DIAG_GLOBAL
+//     -> CMD_DIAG type checksum(4) timeout(4) oversize(4) syntax(4)
+//        uart_overrun(4) uart_dropped(4) n cmd...     (frame errors, UART
+//        receive losses and the IDs of the n commands with statistics)
+//   CMD_DIAG BTCOM_DIAG_COMMAND cmd
+//     -> CMD_DIAG type cmd calls(4) rejected(4) cycles(8) cycles_max(4)
+//        latency(8) latency_max(4)
+//   CMD_DIAG BTCOM_DIAG_RESET
+// cycles: handler execution time, latency: end of the request frame until
+// the last response byte was handed to the UART (core timer counts, SYSCLK/2,
+// totals over all calls). Statistics are kept for the first BTCOM_STATS_CMDS
+// registered commands used, IDs without registry entry are not counted.
+#define BTCOM_CMD_DIAG          0xF8
+
+#define BTCOM_DIAG_GLOBAL       0x00
+#define BTCOM_DIAG_COMMAND      0x01
+#define BTCOM_DIAG_RESET        0x02
+
+#define BTCOM_STATS_CMDS        24
+#define BTCOM_DIAG_RESP_MAX     (2 + 6*4 + 1 + BTCOM_STATS_CMDS)     // global, command: 3 + 4*4 + 2*8
+
+
+// BLE connection made or lost. The HM-17 reports it between frames with
+// "OK+CONN" / "OK+LOST" (AT+NOTI1, set by the baud rate negotiation). BTCom
+// drops the cached responses and the stream, the firmware drops its
+// subscriptions in the callback (BTCom_SetLinkCallback)
+typedef void (*BTComLinkCallback)();
+
+
+// fill <buf> with up to <max> bytes of the stream at <offset>, returns the
+// number of bytes (0 = end of stream)
+typedef WORD (*BTComStreamProducer)(void *ctx, DWORD offset, BYTE *buf, WORD max);
+
+
+// command callback: request in buf_in, response to buf_out (same buffer).
+// *len holds the request length + 1 on entry (v1: including the checksum
+// byte) and must be set to the response length.
+typedef void (*VoidFnctCallback)( BYTE*, BYTE*, WORD *);
+
+
+// command registry entry, lengths including the command byte.
+// Requests outside [reqMin, reqMax] are rejected before the callback runs.
 typedef struct
 {
 	VoidFnctCallback callback;
-	BYTE CmdID;
+	WORD reqMax;
+	WORD respMax;       // longest response of the callback, BTCOM_LEN_ECHO
+	BYTE id;            // command ID
+	BYTE reqMin;
 }CommandStruct;	
 
+#define BTCOM_LEN_ANY           MAX_PACKET_SIZE
+#define BTCOM_LEN_ECHO          0       // response is the request (respMax)
+
+// registry entry: BTCOM_COMMAND(CMD_ID, callback, reqMin, reqMax, respMax),
+#define BTCOM_COMMAND(cmd, cb, reqmin, reqmax, respmax)  { cb, reqmax, respmax, cmd, reqmin }
+#ifdef BTCOM_DIAG
+#define BTCOM_COMMAND_DIAG      BTCOM_COMMAND(BTCOM_CMD_DIAG, BTCom_diagCallback, 2, 3, BTCOM_DIAG_RESP_MAX)
+#endif
+#ifdef BTCOM_STREAMING
+#define BTCOM_COMMAND_STREAM    BTCOM_COMMAND(BTCOM_CMD_STREAM, BTCom_streamCallback, 2, 3, 3)
+#endif
+#ifdef BTCOM_BATCH
+#define BTCOM_COMMAND_BATCH     BTCOM_COMMAND(BTCOM_CMD_BATCH, BTCom_batchCallback, 1, BTCOM_LEN_ANY, BTCOM_LEN_ANY)
+#endif
+
+// command registry, defined by each firmware with the entries sorted by
+// command ID (binary search, BTCom_Init() halts on an unsorted registry).
+// Commands without entry are echoed by BTCom_defaultCallback().
+extern const CommandStruct BTCom_commands[];
+extern const WORD BTCom_commandCount;
+
 
 void BTCom_Init();
 BYTE BTCom_Task();
-void BTCom_addCallback(BYTE CmdID, VoidFnctCallback callback);
+BYTE BTCom_IdleTask();
+void BTCom_defaultCallback(BYTE *buf_in, BYTE *buf_out, WORD *len);
+#ifdef BTCOM_BATCH
+void BTCom_batchCallback(BYTE *buf_in, BYTE *buf_out, WORD *len);
+#endif
+#ifdef BTCOM_STREAMING
+void BTCom_streamCallback(BYTE *buf_in, BYTE *buf_out, WORD *len);
+void BTCom_StartStream(BYTE cmd, BYTE *params, BTComStreamProducer producer, void *ctx);
+#endif
+#ifdef BTCOM_DIAG
+void BTCom_diagCallback(BYTE *buf_in, BYTE *buf_out, WORD *len);
+#endif
 
 WORD BTCom_HandleCommand(BYTE *buf_in, BYTE *buf_out, WORD len);
 void BTCom_PutResponse();
+void BTCom_ClearReplay();
+void BTCom_SetLinkCallback(BTComLinkCallback cb);
+#ifdef BTCOM_STREAMING
+BYTE BTCom_PutNotification(BYTE *data, WORD len);
+#endif
 
 BYTE BTCom_injectCommand(char *str);
 
@@ -0,0 +1,140 @@
+// BLE protocol frame decoder
+// (C) 2023-09-09 by Daniel Porzig
+
+#include "BTComDecoder.h"
+#include "CRC16.h"
+
+
+void BTComDecoder_Init(BTComDecoderStruct *dec, BYTE *buf, WORD size)
+{
+    dec->buf = buf;
+    dec->size = size;
+    BTComDecoder_Reset(dec);
+}
+
+// drop a partially received frame
+void BTComDecoder_Reset(BTComDecoderStruct *dec)
+{
+    dec->state = BTCOMDEC_STATE_IDLE;
+    dec->count = 0;
+    dec->checksum = 0;
+    dec->version = 1;
+}
+
+// decode up to <n> bytes, returns the number of bytes consumed. stops behind
+// the ETX (or the offending byte) of a frame, its result is put to *status
+WORD BTComDecoder_Feed(BTComDecoderStruct *dec, BYTE *data, WORD n, BYTE *status)
+{
+    // decoder state kept in locals inside the loop
+    BYTE state = dec->state;
+    BYTE checksum = dec->checksum;
+    WORD count = dec->count;
+    BYTE *buf = dec->buf;
+    WORD size = dec->size;
+    BYTE RXByte;
+    WORD i = 0;
+
+    *status = BTCOMDEC_NONE;
+
+    while(i < n)
+    {
+        RXByte = data[i++];
+
+        switch(state)
+        {
+            case BTCOMDEC_STATE_IDLE:
+                // wait for first STX, ignore anything else
+                if(RXByte == STX)
+                {
+                    state = BTCOMDEC_STATE_STARTSEQ;
+                }
+            continue;
+
+            case BTCOMDEC_STATE_STARTSEQ:
+                if(RXByte == STX || RXByte == STX2)
+                {
+                    // second start byte received, following bytes are data
+                    // v2: buf[0] is kept free for the response status
+                    dec->version = (RXByte == STX2) ? 2 : 1;
+                    count = dec->version - 1;
+                    checksum = 0;
+                    state = BTCOMDEC_STATE_DATA;
+                }
+                else
+                {
+                    // unexpected data, no frame started
+                    state = BTCOMDEC_STATE_IDLE;
+                }
+            continue;
+
+            case BTCOMDEC_STATE_DATA:
+                if(RXByte == STX)
+                {
+                    // start over, start byte follows
+                    state = BTCOMDEC_STATE_STARTSEQ;
+                    continue;
+                }
+                if(RXByte == DLE)
+                {
+                    // next byte is to be treated as data
+                    state = BTCOMDEC_STATE_DLE;
+                    continue;
+                }
+                if(RXByte == ETX)
+                {
+                    state = BTCOMDEC_STATE_IDLE;
+
+                    if(dec->version == 2)
+                    {
+                        // reserved byte, seq, cmd, CRC
+                        if(count < 5)
+                        {
+                            *status = BTCOMDEC_ERR_SYNTAX;
+                        }
+                        else if(CRC16_Update(CRC16_INIT, &buf[1], count - 3) ==
+                                (((WORD)buf[count-2] << 8) | buf[count-1]))
+                        {
+                            *status = BTCOMDEC_DONE;
+                        }
+                        else
+                        {
+                            *status = BTCOMDEC_ERR_CHECKSUM;
+                        }
+                    }
+                    else
+                    {
+                        // sum over data and checksum byte is 0
+                        *status = (checksum == 0) ? BTCOMDEC_DONE : BTCOMDEC_ERR_CHECKSUM;
+                    }
+                    break;
+                }
+            // regular data byte
+            break;
+
+            case BTCOMDEC_STATE_DLE:
+                state = BTCOMDEC_STATE_DATA;
+            break;
+        }
+
+        if(*status != BTCOMDEC_NONE)
+        {
+            break;
+        }
+
+        // store data byte
+        if(count >= size)
+        {
+            state = BTCOMDEC_STATE_IDLE;
+            *status = BTCOMDEC_ERR_SIZE;
+            break;
+        }
+        checksum += RXByte;
+        buf[count++] = RXByte;
+    }
+
+    dec->state = state;
+    dec->checksum = checksum;
+    dec->count = count;
+
+    return i;
+}
@@ -0,0 +1,57 @@
+// BLE protocol frame decoder
+// (C) 2023-09-09 by Daniel Porzig
+
+#ifndef _BTCOMDECODER_H_
+#define _BTCOMDECODER_H_
+
+#include <GenericTypeDefs.h>
+
+// Incremental decoder for <STX><STX|STX2> data <ETX> frames with DLE
+// stuffing (v1: additive checksum, v2: CRC16, see BTCom.h).
+// All state lives in the decoder object, so it can be fed from the UART,
+// the console command injector or a host test. BTComDecoder_Feed() decodes a
+// byte span in one loop and stops behind each completed or failed frame.
+//
+// Decoded frame in buf: v1  command data... checksum
+//                       v2  (reserved) seq command data... crc_hi crc_lo
+// buf must be set before a frame starts (state BTCOMDEC_STATE_IDLE), it is
+// used until the frame is done.
+
+//Communications Control bytes
+#define STX             0x55
+#define STX2            0x56    // second start byte of a v2 frame
+#define ETX             0x04
+#define DLE             0x05
+
+// decoder states
+#define BTCOMDEC_STATE_IDLE     0
+#define BTCOMDEC_STATE_STARTSEQ 1       // first STX received
+#define BTCOMDEC_STATE_DATA     2
+#define BTCOMDEC_STATE_DLE      3       // next byte is data
+
+// frame status
+#define BTCOMDEC_NONE           0       // frame not complete yet
+#define BTCOMDEC_DONE           1       // frame ok
+#define BTCOMDEC_ERR_CHECKSUM   2       // checksum / CRC error
+#define BTCOMDEC_ERR_SIZE       3       // frame exceeds buffer size
+#define BTCOMDEC_ERR_SYNTAX     4       // v2 frame too short
+
+typedef struct
+{
+    BYTE *buf;          // decoded frame
+    WORD size;          // size of buf
+    WORD count;         // decoded bytes
+    BYTE state;
+    BYTE version;       // 1 or 2, valid once the frame started
+    BYTE checksum;      // v1 running sum
+}BTComDecoderStruct;
+
+// frame data is being received (decoder state beyond the start sequence)
+#define BTComDecoder_InFrame(d)     ((d)->state >= BTCOMDEC_STATE_DATA)
+
+
+void BTComDecoder_Init(BTComDecoderStruct *dec, BYTE *buf, WORD size);
+void BTComDecoder_Reset(BTComDecoderStruct *dec);
+WORD BTComDecoder_Feed(BTComDecoderStruct *dec, BYTE *data, WORD n, BYTE *status);
+
+#endif
@@ -52,6 +52,7 @@
 typedef struct cfg_bootcode_TD
 {
     DWORD magicnumber;
+    DWORD blebaud;          // HM-17 UART rate of the last negotiation, shared by app and bootloader
 
 }cfg_bootcode_struct;
 
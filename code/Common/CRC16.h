@@ -0,0 +1,18 @@
+// CRC16 checksum module
+// (C) 2023-09-09 by Daniel Porzig
+
+#ifndef _CRC16_H_
+#define _CRC16_H_
+
+#include <GenericTypeDefs.h>
+
+// CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF, no reflection,
+// no final XOR. check value of "123456789" is 0x29B1
+
+#define CRC16_INIT      0xFFFF
+
+
+WORD CRC16_Update(WORD crc, BYTE *data, WORD len);
+WORD CRC16_UpdateByte(WORD crc, BYTE data);
+
+#endif
@@ -1,63 +1,129 @@
 
+
+
 #include "circbuffer.h"
 
+// keep the compiler from moving buffer accesses across an index update
+#define CIRC_BUFFER_BARRIER()   asm volatile("" ::: "memory")
+
 
-void CircBufferInit(CircBuffer *CB)
+void CircBufferInit(CircBuffer *CB, BYTE *storage, WORD size)
 {
-    CB->count = 0;
-    CB->read = CB->buffer;
-    CB->write = CB->buffer;
+    CB->buffer = storage;
+    CB->mask = size - 1;
+    CB->head = 0;
+    CB->tail = 0;
 }
 
 BYTE CircBufferIsEmpty(CircBuffer *CB)
 {
-    return (CB->count == 0);
+    return (CB->head == CB->tail);
 }
 
 BYTE CircBufferIsFull(CircBuffer *CB)
 {
-    return (CB->count == CIRC_BUFFER_SIZE);
+    return ((WORD)(CB->head - CB->tail) > CB->mask);
+}
+
+WORD CircBufferGetCount(CircBuffer *CB)
+{
+    return (WORD)(CB->head - CB->tail);
 }
 
-BYTE CircBufferGetCount(CircBuffer *CB)
+WORD CircBufferGetFree(CircBuffer *CB)
 {
-    return (CB->count);
+    return CB->mask + 1 - (WORD)(CB->head - CB->tail);
 }
 
 
-void CircBufferWrite(CircBuffer *CB, BYTE val)
+// returns 0 if the buffer is full, the value is dropped then
+BYTE CircBufferWrite(CircBuffer *CB, BYTE val)
 {
+    WORD head = CB->head;
+
+    if((WORD)(head - CB->tail) > CB->mask)
+    {
+        return 0;
+    }
+
     // store value in ring buffer
-    *CB->write = val;
-    // move write pointer
-    CB->write++;
-    // check write pointer range
-    if(CB->write >= (CB->buffer + CIRC_BUFFER_SIZE))
+    CB->buffer[head & CB->mask] = val;
+
+    // publish value
+    CIRC_BUFFER_BARRIER();
+    CB->head = head + 1;
+
+    return 1;
+}
+
+// returns the contiguous free space at the write position, fill it and
+// call CircBufferWriteCommit() with the number of bytes written
+WORD CircBufferWriteSpan(CircBuffer *CB, BYTE **data)
+{
+    WORD head = CB->head;
+    WORD ofs = head & CB->mask;
+    WORD n = CB->mask + 1 - (WORD)(head - CB->tail);
+
+    if(n > CB->mask + 1 - ofs)
     {
-        // wrap write pointer around
-        CB->write = CB->buffer;
+        n = CB->mask + 1 - ofs;
     }
-    // increase element count
-    CB->count++;
+
+    *data = &CB->buffer[ofs];
+    return n;
+}
+
+void CircBufferWriteCommit(CircBuffer *CB, WORD n)
+{
+    CIRC_BUFFER_BARRIER();
+    CB->head += n;
 }
 
+
+// read one value, the buffer must not be empty
 BYTE CircBufferRead(CircBuffer *CB)
 {
+    WORD tail = CB->tail;
     BYTE t;
+
     // get value from ring buffer
-    t = *CB->read;
-    // move read pointer
-    CB->read++;
-    // check write pointer range
-    if(CB->read >= (CB->buffer + CIRC_BUFFER_SIZE))
-    {
-        // wrap write pointer around
-        CB->read = CB->buffer;
-    }
-    // decrease element count
-    CB->count--;
+    t = CB->buffer[tail & CB->mask];
+
+    // release slot
+    CIRC_BUFFER_BARRIER();
+    CB->tail = tail + 1;
+
     // return ring buffer content
     return t;
 }
 
+// returns the number of contiguous bytes at the read position, they can be
+// parsed in place and are released by CircBufferReadCommit()
+WORD CircBufferReadSpan(CircBuffer *CB, BYTE **data)
+{
+    WORD tail = CB->tail;
+    WORD ofs = tail & CB->mask;
+    WORD n = (WORD)(CB->head - tail);
 
+    if(n > CB->mask + 1 - ofs)
+    {
+        n = CB->mask + 1 - ofs;
+    }
+
+    CIRC_BUFFER_BARRIER();
+
+    *data = &CB->buffer[ofs];
+    return n;
+}
+
+void CircBufferReadCommit(CircBuffer *CB, WORD n)
+{
+    CIRC_BUFFER_BARRIER();
+    CB->tail += n;
+}
+
+// discard all data, consumer side
+void CircBufferFlush(CircBuffer *CB)
+{
+    CB->tail = CB->head;
+}
@@ -8,27 +8,40 @@
 #include "uart2.h"
 
 // UART RingBuffer
+//
+// Single producer / single consumer ring (e.g. producer = ISR, consumer =
+// task), no interrupt masking needed: head is only written by the producer,
+// tail only by the consumer. Both indices run freely and are masked on
+// access, so a full buffer can be told apart from an empty one.
+// The storage is passed to CircBufferInit(), its size must be a power of 2.
 
-#define CIRC_BUFFER_SIZE    256
+#define CIRC_BUFFER_SIZE    256     // default size of the UART buffers
 
 typedef struct CircBuffer_TD
 {
-    BYTE buffer[CIRC_BUFFER_SIZE];
-    BYTE *read;
-    BYTE *write;
-    BYTE count;
+    BYTE *buffer;
+    WORD mask;              // size - 1
+    volatile WORD head;     // next write position, producer only
+    volatile WORD tail;     // next read position, consumer only
 }CircBuffer;
 
 
-void CircBufferInit(CircBuffer *CB);
+void CircBufferInit(CircBuffer *CB, BYTE *storage, WORD size);
 BYTE CircBufferIsEmpty(CircBuffer *CB);
 BYTE CircBufferIsFull(CircBuffer *CB);
-BYTE CircBufferGetCount(CircBuffer *CB);
-void CircBufferWrite(CircBuffer *CB, BYTE val);
-BYTE CircBufferRead(CircBuffer *CB);
-
+WORD CircBufferGetCount(CircBuffer *CB);
+WORD CircBufferGetFree(CircBuffer *CB);
 
-#endif
+// producer side
+BYTE CircBufferWrite(CircBuffer *CB, BYTE val);
+WORD CircBufferWriteSpan(CircBuffer *CB, BYTE **data);
+void CircBufferWriteCommit(CircBuffer *CB, WORD n);
 
+// consumer side
+BYTE CircBufferRead(CircBuffer *CB);
+WORD CircBufferReadSpan(CircBuffer *CB, BYTE **data);
+void CircBufferReadCommit(CircBuffer *CB, WORD n);
+void CircBufferFlush(CircBuffer *CB);
 
 
+#endif
@@ -0,0 +1,50 @@
+// stackless coroutine (protothread) module
+// (C) 2023-09-09 by Daniel Porzig
+
+#ifndef _COROUTINE_H_
+#define _COROUTINE_H_
+
+#include "GenericTypeDefs.h"
+
+// A coroutine is a function returning CR_WAITING or CR_DONE. When it yields,
+// the next call (usually from a scheduler task on a later tick) resumes right
+// after the yield point.
+//
+// NOTE: local variables are NOT preserved across a yield, keep all state that
+// is needed after a yield in static variables or a context struct.
+// The resume point is a case label of a switch statement, so switch() must
+// not be used directly inside a coroutine body.
+
+#define CR_WAITING      0
+#define CR_DONE         1
+
+typedef struct
+{
+    WORD lc;        // resume point (source line), 0 = start
+}CoroutineStruct;
+
+
+#define CR_INIT(cr)                 ((cr)->lc = 0)
+
+#define CR_BEGIN(cr)                switch((cr)->lc) { case 0:
+
+#define CR_END(cr)                  } (cr)->lc = 0; return CR_DONE
+
+// return and continue here on the next call
+#define CR_YIELD(cr)                do { (cr)->lc = __LINE__; return CR_WAITING; case __LINE__:; } while(0)
+
+// return until cond is true, cond is evaluated on every call
+#define CR_WAIT_UNTIL(cr, cond)     do { (cr)->lc = __LINE__; case __LINE__: if(!(cond)) return CR_WAITING; } while(0)
+
+// return and continue on the <ticks>th next call (ticks >= 1), cnt is a
+// counter variable that survives the yield
+#define CR_DELAY(cr, cnt, ticks)    do { (cnt) = (ticks); (cr)->lc = __LINE__; return CR_WAITING; case __LINE__: if(--(cnt) != 0) return CR_WAITING; } while(0)
+
+// return and continue after <ticks> scheduler ticks (ticks >= 1). only for a
+// coroutine that runs as its own scheduler task, skiprate is the task's one
+#define CR_SLEEP(cr, skiprate, ticks)   do { *(skiprate) = (ticks); CR_YIELD(cr); } while(0)
+
+// run a child coroutine until it is done
+#define CR_WAIT_CHILD(cr, call)     CR_WAIT_UNTIL(cr, (call) == CR_DONE)
+
+#endif
@@ -0,0 +1,64 @@
+// ISR to task event queue module
+// (C) 2023-09-09 by Daniel Porzig
+
+#include "EventQueue.h"
+#include <plib.h>
+
+// keeps the compiler from moving the event write behind the index update
+#define EVENTQUEUE_BARRIER()    __asm__ __volatile__("" ::: "memory")
+
+
+// must be called before the producer interrupt is enabled
+void EventQueue_Init(EventQueueStruct *q)
+{
+    q->head = 0;
+    q->tail = 0;
+    q->dropped = 0;
+}
+
+// producer side, called from interrupt context. returns 0 if the queue is full
+BYTE EventQueue_Post(EventQueueStruct *q, BYTE type, WORD param1, WORD param2)
+{
+    BYTE head = q->head;
+    EventStruct *ev;
+
+    if((BYTE)(head - q->tail) >= EVENTQUEUE_SIZE)
+    {
+        q->dropped++;
+        return 0;
+    }
+
+    ev = &q->buf[head & EVENTQUEUE_MASK];
+    ev->timestamp = ReadCoreTimer();
+    ev->param1 = param1;
+    ev->param2 = param2;
+    ev->type = type;
+
+    EVENTQUEUE_BARRIER();
+    q->head = head + 1;
+
+    return 1;
+}
+
+// consumer side, called from task context. returns 0 if the queue is empty
+BYTE EventQueue_Get(EventQueueStruct *q, EventStruct *ev)
+{
+    BYTE tail = q->tail;
+
+    if(tail == q->head)
+    {
+        return 0;
+    }
+
+    *ev = q->buf[tail & EVENTQUEUE_MASK];
+
+    EVENTQUEUE_BARRIER();
+    q->tail = tail + 1;
+
+    return 1;
+}
+
+BYTE EventQueue_Count(EventQueueStruct *q)
+{
+    return (BYTE)(q->head - q->tail);
+}
@@ -0,0 +1,42 @@
+// ISR to task event queue module
+// (C) 2023-09-09 by Daniel Porzig
+
+#ifndef _EVENTQUEUE_H_
+#define _EVENTQUEUE_H_
+
+#include <stdlib.h>
+#include "HardwareProfile.h"
+#include <GenericTypeDefs.h>
+
+// Lock-free single producer / single consumer queue. The producer is an
+// interrupt service routine (or several ISRs on the SAME priority level, they
+// can not preempt each other), the consumer is the task owning the queue.
+// head is only written by the producer, tail only by the consumer.
+
+// number of events, must be a power of two <= 128
+#define EVENTQUEUE_SIZE     32
+#define EVENTQUEUE_MASK     (EVENTQUEUE_SIZE - 1)
+
+typedef struct
+{
+    DWORD timestamp;        // core timer count (SYSCLK/2) when the event was posted
+    WORD param1;
+    WORD param2;
+    BYTE type;
+}EventStruct;
+
+typedef struct
+{
+    EventStruct buf[EVENTQUEUE_SIZE];
+    volatile BYTE head;     // next slot to write (producer)
+    volatile BYTE tail;     // next slot to read (consumer)
+    volatile WORD dropped;  // number of events lost because the queue was full
+}EventQueueStruct;
+
+
+void EventQueue_Init(EventQueueStruct *q);
+BYTE EventQueue_Post(EventQueueStruct *q, BYTE type, WORD param1, WORD param2);
+BYTE EventQueue_Get(EventQueueStruct *q, EventStruct *ev);
+BYTE EventQueue_Count(EventQueueStruct *q);
+
+#endif
@@ -81,7 +81,8 @@
 #define BRG_DIV_UART2           4   // this is NOT the baud rate register value!
 #define BRGH_UART2              1
 
-#define BAUDRATE_UART1      9600UL
+#define BAUDRATE_UART1      9600UL      // HM-17 default, used until the rate is negotiated
+#define BAUDRATE_UART1_MAX  230400UL    // fastest rate for the HM-17 negotiation
 //// for PBCLOCK 40MHz
 #define BRG_DIV_UART1           16   // this is NOT the baud rate register value!
 #define BRGH_UART1              0
@@ -92,7 +93,7 @@
 //#define BRGH_UART2               0
 
 
-#define DEBUG_puts      UART2PrintString
+#define DEBUG_puts      UART2_DMAPrintString
 
 
 
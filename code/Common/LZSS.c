@@ -0,0 +1,82 @@
+// LZSS stream decompression
+// (C) 2023-09-09 by Daniel Porzig
+
+#include "LZSS.h"
+#include <string.h>
+
+#define LZSS_WINDOW_MASK        (LZSS_WINDOW_SIZE - 1)
+
+
+void LZSS_Init(LZSSDecoderStruct *dec, BYTE *window)
+{
+    dec->window = window;
+    dec->pos = 0;
+    dec->flags = 1;
+    dec->copyLen = 0;
+    dec->matchPending = 0;
+    memset(window, 0, LZSS_WINDOW_SIZE);
+}
+
+// decompress from <in> (*inlen bytes) into <out>, up to <outmax> bytes.
+// returns the number of bytes put to <out>, *inlen is set to the number of
+// input bytes consumed. A match which does not fit into <out> is continued
+// on the next call, so call again until it returns 0.
+WORD LZSS_Decode(LZSSDecoderStruct *dec, BYTE *in, WORD *inlen, BYTE *out, WORD outmax)
+{
+    BYTE *window = dec->window;
+    WORD pos = dec->pos;
+    WORD len = *inlen;
+    WORD i = 0, n = 0;
+    BYTE b;
+
+    while(n < outmax)
+    {
+        if(dec->copyLen > 0)
+        {
+            // continue match
+            b = window[(pos - dec->copyDist) & LZSS_WINDOW_MASK];
+            dec->copyLen--;
+        }
+        else if(i == len)
+        {
+            break;      // input used up
+        }
+        else if(dec->flags == 1)
+        {
+            // sentinel bit reached, next flag byte
+            dec->flags = 0x100 | in[i++];
+            continue;
+        }
+        else if(dec->flags & 1)
+        {
+            // literal
+            b = in[i++];
+            dec->flags >>= 1;
+        }
+        else if(!dec->matchPending)
+        {
+            // first byte of a match
+            dec->match = in[i++];
+            dec->matchPending = 1;
+            continue;
+        }
+        else
+        {
+            b = in[i++];
+            dec->copyDist = (((WORD)dec->match << 2) | (b >> 6)) + 1;
+            dec->copyLen = (b & 0x3F) + LZSS_MIN_MATCH;
+            dec->matchPending = 0;
+            dec->flags >>= 1;
+            continue;
+        }
+
+        window[pos] = b;
+        pos = (pos + 1) & LZSS_WINDOW_MASK;
+        out[n++] = b;
+    }
+
+    dec->pos = pos;
+    *inlen = i;
+
+    return n;
+}
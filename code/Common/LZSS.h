@@ -0,0 +1,37 @@
+// LZSS stream decompression
+// (C) 2023-09-09 by Daniel Porzig
+
+#ifndef _LZSS_H_
+#define _LZSS_H_
+
+#include <GenericTypeDefs.h>
+
+// Compressed stream (written by tools/otapack.py):
+//   flag byte, then 8 items, bit 0 of the flag byte first
+//     bit = 1: literal byte
+//     bit = 0: match, 2 bytes  dddddddd ddllllll
+//              copy length l+3 bytes from distance d+1 back in the output
+// The decoder keeps the last LZSS_WINDOW_SIZE output bytes as history and
+// takes the input in pieces of any size (e.g. one protocol block each).
+// The stream has no end marker, the caller knows the decompressed size.
+
+#define LZSS_WINDOW_SIZE        1024    // history, max. match distance
+#define LZSS_MIN_MATCH          3
+#define LZSS_MAX_MATCH          (LZSS_MIN_MATCH + 63)
+
+typedef struct
+{
+    BYTE *window;       // LZSS_WINDOW_SIZE bytes history
+    WORD pos;           // next write position in window
+    WORD flags;         // item flags, shifted out, 1 = next flag byte due
+    WORD copyDist;      // match being copied
+    BYTE copyLen;
+    BYTE match;         // first byte of a match, if matchPending
+    BYTE matchPending;
+}LZSSDecoderStruct;
+
+
+void LZSS_Init(LZSSDecoderStruct *dec, BYTE *window);
+WORD LZSS_Decode(LZSSDecoderStruct *dec, BYTE *in, WORD *inlen, BYTE *out, WORD outmax);
+
+#endif
@@ -0,0 +1,231 @@
+// deferred binary logging module
+// (C) 2023-09-09 by Daniel Porzig
+
+#include "Log.h"
+#include "uart2.h"
+#include <plib.h>
+#include <string.h>
+#include <stdio.h>
+
+#define LOG_BUFFER_MASK     (LOG_BUFFER_SIZE - 1)
+
+#define LOG_LINE_LEN        120     // longest formatted record
+#define LOG_CONV_LEN        24      // longest single conversion (e.g. %f)
+
+BYTE Log_level[LOG_NUM_MODULES];
+
+static LogRecordStruct Log_buf[LOG_BUFFER_SIZE];
+static WORD Log_head = 0;           // free running, written by Log_Write()
+static WORD Log_tail = 0;           // free running, read by Log_Task()
+static WORD Log_seq = 0;            // number of the next record
+static WORD Log_nextseq = 0;        // record number expected by Log_Task()
+
+typedef union
+{
+    float f;
+    DWORD bits;
+}LogFloatUnion;
+
+
+void Log_Init()
+{
+    BYTE i;
+
+    for(i=0; i<LOG_NUM_MODULES; i++)
+    {
+        Log_level[i] = LOG_DEFAULT_LEVEL;
+    }
+
+    Log_head = 0;
+    Log_tail = 0;
+    Log_seq = 0;
+    Log_nextseq = 0;
+}
+
+void Log_SetLevel(BYTE module, BYTE level)
+{
+    if(module < LOG_NUM_MODULES)
+    {
+        Log_level[module] = level;
+    }
+}
+
+// store a record, use the LOGx() macros. a record is lost if the ring is full
+void Log_Write(BYTE module, BYTE level, const char *fmt, DWORD a, DWORD b, DWORD c, DWORD d)
+{
+    LogRecordStruct *rec;
+    WORD seq = Log_seq++;
+
+    if((WORD)(Log_head - Log_tail) >= LOG_BUFFER_SIZE)
+    {
+        return;
+    }
+
+    rec = &Log_buf[Log_head & LOG_BUFFER_MASK];
+    rec->fmt = fmt;
+    rec->arg[0] = a;
+    rec->arg[1] = b;
+    rec->arg[2] = c;
+    rec->arg[3] = d;
+    rec->timestamp = ReadCoreTimer();
+    rec->module = module;
+    rec->level = level;
+    rec->seq = seq;
+
+    Log_head++;
+}
+
+DWORD Log_FloatBits(float f)
+{
+    LogFloatUnion u;
+
+    u.f = f;
+    return u.bits;
+}
+
+// format a record like sprintf() would have done, returns the text length.
+// supports flags, width, precision and the conversions d i u x X o c s f e g
+WORD Log_Format(LogRecordStruct *rec, char *out, WORD size)
+{
+    const char *p = rec->fmt;
+    char spec[12];
+    WORD n = 0;
+    BYTE s, argn = 0;
+    DWORD arg;
+    LogFloatUnion u;
+    const char *str;
+
+    while(*p && n < size-1)
+    {
+        if(*p != '%')
+        {
+            out[n++] = *p++;
+            continue;
+        }
+
+        // collect the conversion spec
+        s = 0;
+        spec[s++] = *p++;
+        while(*p && strchr("-+ #0123456789.lh", *p) && s < sizeof(spec)-2)
+        {
+            spec[s++] = *p++;
+        }
+        if(*p == 0)
+        {
+            break;
+        }
+        spec[s++] = *p;
+        spec[s] = 0;
+
+        if(*p == '%')
+        {
+            out[n++] = '%';
+            p++;
+            continue;
+        }
+
+        if(size - n < LOG_CONV_LEN)
+        {
+            break;      // line too long
+        }
+
+        arg = (argn < LOG_MAX_ARGS) ? rec->arg[argn++] : 0;
+
+        switch(*p++)
+        {
+            case 'f':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+                u.bits = arg;
+                n += sprintf(&out[n], spec, (double)u.f);
+            break;
+
+            case 's':
+                str = (const char*)arg;
+                while(*str && n < size-1)
+                {
+                    out[n++] = *str++;
+                }
+            break;
+
+            case 'c':
+            case 'd':
+            case 'i':
+                n += sprintf(&out[n], spec, (int)arg);
+            break;
+
+            default:
+                n += sprintf(&out[n], spec, arg);
+            break;
+        }
+    }
+
+    out[n] = 0;
+    return n;
+}
+
+// output one record, called in the scheduler idle time.
+// returns 1 if a record was sent, 0 if there is nothing to do or the console
+// transmit buffer is full
+BYTE Log_Task()
+{
+    LogRecordStruct *rec;
+#ifdef LOG_BINARY_OUTPUT
+    BYTE frame[sizeof(LogRecordStruct) + 3];
+    BYTE *src;
+    BYTE sum = 0;
+    WORD i;
+#else
+    char txt[LOG_LINE_LEN];
+#endif
+
+    if(Log_head == Log_tail)
+    {
+        return 0;
+    }
+
+    rec = &Log_buf[Log_tail & LOG_BUFFER_MASK];
+
+#ifdef LOG_BINARY_OUTPUT
+    // lost records show up as gaps in the record numbers on the host
+    if(UART2_DMATxFree() < sizeof(frame))
+    {
+        return 0;
+    }
+
+    src = (BYTE*)rec;
+    frame[0] = LOG_SYNC1;
+    frame[1] = LOG_SYNC2;
+    for(i=0; i<sizeof(LogRecordStruct); i++)
+    {
+        frame[i+2] = src[i];
+        sum += src[i];
+    }
+    frame[i+2] = sum;
+
+    UART2_DMAWrite(frame, sizeof(frame));
+#else
+    if(UART2_DMATxFree() < LOG_LINE_LEN)
+    {
+        return 0;
+    }
+
+    if(rec->seq != Log_nextseq)
+    {
+        sprintf(txt,"\n\rLOG: %u records lost\n\r",(WORD)(rec->seq - Log_nextseq));
+        DEBUG_puts(txt);
+        Log_nextseq = rec->seq;
+        return 1;
+    }
+
+    Log_Format(rec, txt, sizeof(txt));
+    DEBUG_puts(txt);
+#endif
+
+    Log_nextseq = rec->seq + 1;
+    Log_tail++;
+
+    return 1;
+}
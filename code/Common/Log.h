@@ -0,0 +1,93 @@
+// deferred binary logging module
+// (C) 2023-09-09 by Daniel Porzig
+
+#ifndef _LOG_H_
+#define _LOG_H_
+
+#include <stdlib.h>
+#include "HardwareProfile.h"
+#include <GenericTypeDefs.h>
+
+// A log call only stores a record (format string address + raw arguments +
+// core timer timestamp) in a RAM ring, no formatting is done on the caller's
+// path. Log_Task() formats the records in the scheduler idle time and prints
+// them to the debug console, or with LOG_BINARY_OUTPUT sends the raw records
+// to the host, where tools/logdecode.py reads the format strings from the ELF.
+//
+// NOTE: log only from task context. the format string must be a literal, "%s"
+// arguments must point to constant strings (they are read when formatting).
+
+// send raw records instead of text (decoded by tools/logdecode.py)
+//#define LOG_BINARY_OUTPUT
+
+// record ring size, power of 2
+#define LOG_BUFFER_SIZE     32
+
+#define LOG_MAX_ARGS        4
+
+// modules
+#define LOG_MOD_SYS         0
+#define LOG_MOD_BTCOM       1
+#define LOG_MOD_FANCTL      2
+#define LOG_MOD_DEVCTL      3
+#define LOG_MOD_TIMEKEEPER  4
+#define LOG_NUM_MODULES     5
+
+// levels, a record is stored if its level <= the module level
+#define LOG_LEVEL_OFF       0
+#define LOG_LEVEL_ERROR     1
+#define LOG_LEVEL_WARN      2
+#define LOG_LEVEL_INFO      3
+#define LOG_LEVEL_DEBUG     4
+
+#define LOG_DEFAULT_LEVEL   LOG_LEVEL_INFO
+
+// binary output frame: LOG_SYNC1, LOG_SYNC2, record, checksum (sum of record bytes)
+#define LOG_SYNC1           0x1B
+#define LOG_SYNC2           'L'
+
+
+typedef struct
+{
+    const char *fmt;            // format string, also the record ID on the host
+    DWORD arg[LOG_MAX_ARGS];    // raw arguments, floats as IEEE754 bits
+    DWORD timestamp;            // core timer (SYSCLK/2)
+    BYTE module;
+    BYTE level;
+    WORD seq;                   // record number, gaps show lost records
+}LogRecordStruct;
+
+extern BYTE Log_level[LOG_NUM_MODULES];
+
+
+#ifndef _BOOTLOADER_
+#define LOG_ENABLED(mod, lvl)   ((lvl) <= Log_level[mod])
+
+#define LOG(mod, lvl, fmt)                  do { if(LOG_ENABLED(mod, lvl)) Log_Write(mod, lvl, fmt, 0, 0, 0, 0); } while(0)
+#define LOG1(mod, lvl, fmt, a)              do { if(LOG_ENABLED(mod, lvl)) Log_Write(mod, lvl, fmt, (DWORD)(a), 0, 0, 0); } while(0)
+#define LOG2(mod, lvl, fmt, a, b)           do { if(LOG_ENABLED(mod, lvl)) Log_Write(mod, lvl, fmt, (DWORD)(a), (DWORD)(b), 0, 0); } while(0)
+#define LOG3(mod, lvl, fmt, a, b, c)        do { if(LOG_ENABLED(mod, lvl)) Log_Write(mod, lvl, fmt, (DWORD)(a), (DWORD)(b), (DWORD)(c), 0); } while(0)
+#define LOG4(mod, lvl, fmt, a, b, c, d)     do { if(LOG_ENABLED(mod, lvl)) Log_Write(mod, lvl, fmt, (DWORD)(a), (DWORD)(b), (DWORD)(c), (DWORD)(d)); } while(0)
+#else
+// the bootloader has no log (Log.c is not linked), records are dropped
+#define LOG_ENABLED(mod, lvl)   0
+
+#define LOG(mod, lvl, fmt)                  do { } while(0)
+#define LOG1(mod, lvl, fmt, a)              do { } while(0)
+#define LOG2(mod, lvl, fmt, a, b)           do { } while(0)
+#define LOG3(mod, lvl, fmt, a, b, c)        do { } while(0)
+#define LOG4(mod, lvl, fmt, a, b, c, d)     do { } while(0)
+#endif
+
+// float argument for %f/%e/%g, stored without conversion
+#define LOG_FLOAT(f)            Log_FloatBits(f)
+
+
+void Log_Init();
+void Log_SetLevel(BYTE module, BYTE level);
+void Log_Write(BYTE module, BYTE level, const char *fmt, DWORD a, DWORD b, DWORD c, DWORD d);
+DWORD Log_FloatBits(float f);
+BYTE Log_Task();
+WORD Log_Format(LogRecordStruct *rec, char *out, WORD size);
+
+#endif
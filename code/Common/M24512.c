@@ -98,15 +98,45 @@ BYTE EEPROM_read(WORD address, BYTE *data, WORD length)
 
 
 
+// write up to one page of data in a single transaction (must not cross a page boundary)
+static void EEPROM_write_page(WORD add, BYTE *bptr, BYTE b2w)
+{
+	BYTE i;
+	BYTE addhl[2];
+
+    addhl[0] = (add >> 8) & 0xff;	
+    addhl[1] = add  & 0x00ff;
+
+    StartI2C1();        // start condition
+    IdleI2C1();     //Wait to complete    
+
+    MasterWriteI2C1( (_eeaddr << 1) | 0x00  );      // send slave address (write)    
+    IdleI2C1();		//Wait to complete
+
+    MasterWriteI2C1( addhl[0] );    
+    IdleI2C1();		//Wait to complete
+    MasterWriteI2C1( addhl[1] );    
+    IdleI2C1();		//Wait to complete
+
+    for(i=0; i<b2w; i++)
+    {
+        MasterWriteI2C1( *bptr );    // send data byte
+        IdleI2C1();		//Wait to complete     
+        bptr++;
+    }
+
+    StopI2C1();	//Send the Stop condition
+    IdleI2C1();	//Wait to complete        
+}
+
 // perform a write operation (also deals with page boundary crossing)
 BYTE EEPROM_write(WORD address, BYTE *data, WORD length)
 {
 
 	WORD add;
-	BYTE b2w,i;
+	BYTE b2w;
 	BYTE *bptr = data;
 	BYTE offs;
-	BYTE addhl[2];
 	add = address;
 
     // calculate byte offset from page boundary
@@ -116,10 +146,6 @@ BYTE EEPROM_write(WORD address, BYTE *data, WORD length)
 	{
         while(EEPROM_check_busy());
         
-        
-		addhl[0] = (add >> 8) & 0xff;	
-		addhl[1] = add  & 0x00ff;
-
 		// get number of bytes to write
 		if(length > EEPROM_PAGE_SIZE)
 			b2w = EEPROM_PAGE_SIZE;
@@ -133,27 +159,8 @@ BYTE EEPROM_write(WORD address, BYTE *data, WORD length)
         }
 
 		// write bytes to page
-        
-        StartI2C1();        // start condition
-        IdleI2C1();     //Wait to complete    
-
-        MasterWriteI2C1( (_eeaddr << 1) | 0x00  );      // send slave address (write)    
-        IdleI2C1();		//Wait to complete
-
-        MasterWriteI2C1( addhl[0] );    
-        IdleI2C1();		//Wait to complete
-        MasterWriteI2C1( addhl[1] );    
-        IdleI2C1();		//Wait to complete
-
-        for(i=0; i<b2w; i++)
-        {
-            MasterWriteI2C1( *bptr );    // send data byte
-            IdleI2C1();		//Wait to complete     
-            bptr++;
-        }
-        
-        StopI2C1();	//Send the Stop condition
-        IdleI2C1();	//Wait to complete        
+        EEPROM_write_page(add, bptr, b2w);
+        bptr += b2w;
 
 		// increase page address
 		add += b2w;
@@ -168,6 +175,48 @@ BYTE EEPROM_write(WORD address, BYTE *data, WORD length)
 	return 1;
 }
 
+// setup a yielding write operation, see EEPROM_write_cr()
+void EEPROM_write_start(EEPROMWriteContext *ctx, WORD address, BYTE *data, WORD length)
+{
+    CR_INIT(&ctx->cr);
+    ctx->address = address;
+    ctx->data = data;
+    ctx->length = length;
+}
+
+// yielding write operation: writes one chunk of EEPROM_WRITE_CHUNK bytes per
+// call and returns instead of spinning while the EEPROM is busy with its
+// internal write cycle. call (e.g. once per tick) until CR_DONE is returned.
+// every I2C transaction is completed before returning, so the blocking
+// functions can still be used in between
+BYTE EEPROM_write_cr(EEPROMWriteContext *ctx)
+{
+    BYTE b2w;
+
+    CR_BEGIN(&ctx->cr);
+
+    while(ctx->length)
+    {
+        // wait for the end of the previous write cycle (up to 5 ms)
+        CR_WAIT_UNTIL(&ctx->cr, EEPROM_check_busy() == 0);
+
+        // chunks are aligned, so they never cross a page boundary
+        b2w = EEPROM_WRITE_CHUNK - (ctx->address % EEPROM_WRITE_CHUNK);
+        if(b2w > ctx->length)
+        {
+            b2w = ctx->length;
+        }
+
+        EEPROM_write_page(ctx->address, ctx->data, b2w);
+
+        ctx->address += b2w;
+        ctx->data += b2w;
+        ctx->length -= b2w;
+    }
+
+    CR_END(&ctx->cr);
+}
+
 // return page size
 BYTE EEPROM_getPageSize()
 {
@@ -11,14 +11,27 @@
 #include "Compiler.h"
 #include <plib.h>
 #include <proc/p32mx150f128b.h>
+#include "Coroutine.h"
 
 #define EEPROM_PAGE_SIZE		128		// Pagesize in bytes
+#define EEPROM_WRITE_CHUNK      16      // bytes per transaction of EEPROM_write_cr() (~1.3 ms)
+
+// state of a yielding EEPROM write operation
+typedef struct
+{
+    CoroutineStruct cr;
+    WORD address;
+    BYTE *data;
+    WORD length;
+}EEPROMWriteContext;
 
 
 BYTE EEPROM_check_busy();
 void EEPROM_init(BYTE addr);
 BYTE EEPROM_read(WORD address, BYTE *data, WORD length);
 BYTE EEPROM_write(WORD address, BYTE *data, WORD length);
+void EEPROM_write_start(EEPROMWriteContext *ctx, WORD address, BYTE *data, WORD length);
+BYTE EEPROM_write_cr(EEPROMWriteContext *ctx);
 BYTE EEPROM_getPageSize();
 
 
@@ -0,0 +1,201 @@
+// software timer module
+// (C) 2023-09-09 by Daniel Porzig
+
+#include "SoftTimer.h"
+#include <string.h>
+
+#define SOFTTIMER_SLOT_MASK     (SOFTTIMER_WHEEL_SLOTS - 1)
+
+// Wheel[0] holds timers expiring within the next SOFTTIMER_WHEEL_SLOTS ticks,
+// slot = expires & mask. Wheel[n] holds timers expiring within the next
+// 2^(BITS*(n+1)) ticks, slot = (expires >> BITS*n) & mask
+static SoftTimerStruct *Wheel[SOFTTIMER_WHEEL_LEVELS][SOFTTIMER_WHEEL_SLOTS];
+
+// next tick to be processed by SoftTimer_Tick()
+static DWORD SoftTimer_base = 0;
+
+
+// insert timer into the wheel slot matching its remaining time
+static void SoftTimer_Link(SoftTimerStruct *t)
+{
+    DWORD delta = t->expires - SoftTimer_base;
+    BYTE level = 0;
+    SoftTimerStruct **head;
+
+    while(level < SOFTTIMER_WHEEL_LEVELS-1 && delta >= (1UL << (SOFTTIMER_WHEEL_BITS * (level+1))))
+    {
+        level++;
+    }
+
+    head = &Wheel[level][(t->expires >> (SOFTTIMER_WHEEL_BITS * level)) & SOFTTIMER_SLOT_MASK];
+
+    t->next = *head;
+    if(t->next != NULL)
+    {
+        t->next->pprev = &t->next;
+    }
+    *head = t;
+    t->pprev = head;
+}
+
+static void SoftTimer_Unlink(SoftTimerStruct *t)
+{
+    *t->pprev = t->next;
+    if(t->next != NULL)
+    {
+        t->next->pprev = t->pprev;
+    }
+    t->pprev = NULL;
+}
+
+// re-insert all timers of the current slot of <level>, they move at least one
+// level down. returns the slot index, 0 = this level wrapped as well
+static BYTE SoftTimer_Cascade(BYTE level)
+{
+    BYTE idx = (SoftTimer_base >> (SOFTTIMER_WHEEL_BITS * level)) & SOFTTIMER_SLOT_MASK;
+    SoftTimerStruct *t, *list;
+
+    list = Wheel[level][idx];
+    Wheel[level][idx] = NULL;
+
+    while(list != NULL)
+    {
+        t = list;
+        list = t->next;
+        SoftTimer_Link(t);
+    }
+
+    return idx;
+}
+
+
+void SoftTimer_Init()
+{
+    memset(Wheel, 0, sizeof(Wheel));
+    SoftTimer_base = 0;
+}
+
+// (re)start timer, it expires after <ticks> scheduler ticks (min. 1) and then
+// every <period> ticks if period > 0. a pending expired flag is cleared
+void SoftTimer_Start(SoftTimerStruct *t, DWORD ticks, DWORD period, SoftTimerCallback callback)
+{
+    if(t->pprev != NULL)
+    {
+        SoftTimer_Unlink(t);
+    }
+
+    if(ticks == 0)
+    {
+        ticks = 1;
+    }
+    if(ticks > SOFTTIMER_MAX_TICKS)
+    {
+        ticks = SOFTTIMER_MAX_TICKS;
+    }
+    if(period > SOFTTIMER_MAX_TICKS)
+    {
+        period = SOFTTIMER_MAX_TICKS;
+    }
+
+    t->expires = SoftTimer_base + ticks - 1;
+    t->period = period;
+    t->callback = callback;
+    t->expired = 0;
+
+    SoftTimer_Link(t);
+}
+
+// stop timer and discard a pending expiry
+void SoftTimer_Stop(SoftTimerStruct *t)
+{
+    if(t->pprev != NULL)
+    {
+        SoftTimer_Unlink(t);
+    }
+    t->expired = 0;
+}
+
+BYTE SoftTimer_IsRunning(SoftTimerStruct *t)
+{
+    return (t->pprev != NULL);
+}
+
+// returns 1 once per expiry (flag delivery), the flag is cleared on reading
+BYTE SoftTimer_Expired(SoftTimerStruct *t)
+{
+    if(t->expired)
+    {
+        t->expired = 0;
+        return 1;
+    }
+    return 0;
+}
+
+// advance the wheel by one tick and expire all timers due on this tick
+void SoftTimer_Tick()
+{
+    SoftTimerStruct *t, *work;
+    BYTE level, idx;
+
+    idx = SoftTimer_base & SOFTTIMER_SLOT_MASK;
+
+    // level 0 wrapped around: pull down the timers of the next slot(s)
+    if(idx == 0)
+    {
+        for(level=1; level<SOFTTIMER_WHEEL_LEVELS; level++)
+        {
+            if(SoftTimer_Cascade(level) != 0)
+            {
+                break;
+            }
+        }
+    }
+
+    // detach the due list first, so callbacks may start and stop any timer
+    work = Wheel[0][idx];
+    Wheel[0][idx] = NULL;
+    if(work != NULL)
+    {
+        work->pprev = &work;
+    }
+
+    SoftTimer_base++;
+
+    while((t = work) != NULL)
+    {
+        SoftTimer_Unlink(t);
+
+        if(t->period > 0)
+        {
+            t->expires += t->period;
+            SoftTimer_Link(t);
+        }
+
+        t->expired = 1;
+
+        if(t->callback != NULL)
+        {
+            t->callback();
+        }
+    }
+}
+
+// returns the number of ticks until the next tick with work for
+// SoftTimer_Tick() (1 = next tick), max. <max>. used by the tickless scheduler
+BYTE SoftTimer_TicksToNextExpiry(BYTE max)
+{
+    BYTE n, idx;
+
+    for(n=0; n<max; n++)
+    {
+        idx = (SoftTimer_base + n) & SOFTTIMER_SLOT_MASK;
+
+        // a level 0 wrap may cascade timers that are due on the same tick
+        if(Wheel[0][idx] != NULL || idx == 0)
+        {
+            return n + 1;
+        }
+    }
+
+    return max;
+}
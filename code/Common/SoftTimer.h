@@ -0,0 +1,56 @@
+// software timer module
+// (C) 2023-09-09 by Daniel Porzig
+
+#ifndef _SOFTTIMER_H_
+#define _SOFTTIMER_H_
+
+#include <stdlib.h>
+#include "HardwareProfile.h"
+#include <GenericTypeDefs.h>
+
+// Timers are kept in a hierarchical timing wheel driven by the scheduler tick
+// (SoftTimer_Tick() is called by Scheduler_Run()). Start, stop and expiry are
+// O(1), timers of the outer levels are moved one level down (cascaded) when
+// the level below wraps around.
+//
+// NOTE: timers must only be used from task context, not from interrupts.
+
+// scheduler tick in ms
+#define SOFTTIMER_TICK_MS           4
+
+// SOFTTIMER_WHEEL_LEVELS wheels of 2^SOFTTIMER_WHEEL_BITS slots each.
+// 5 x 5 bits -> timeouts up to 2^25 ticks (~37 h), longer ones are clamped
+#define SOFTTIMER_WHEEL_BITS        5
+#define SOFTTIMER_WHEEL_LEVELS      5
+#define SOFTTIMER_WHEEL_SLOTS       (1 << SOFTTIMER_WHEEL_BITS)
+#define SOFTTIMER_MAX_TICKS         ((1UL << (SOFTTIMER_WHEEL_BITS * SOFTTIMER_WHEEL_LEVELS)) - 1)
+
+// conversion to ticks, rounded up
+#define SOFTTIMER_MS(ms)            (((DWORD)(ms) + SOFTTIMER_TICK_MS - 1) / SOFTTIMER_TICK_MS)
+#define SOFTTIMER_SEC(s)            ((DWORD)(s) * (1000 / SOFTTIMER_TICK_MS))
+#define SOFTTIMER_MIN(m)            ((DWORD)(m) * 60 * (1000 / SOFTTIMER_TICK_MS))
+
+
+typedef void (*SoftTimerCallback)( void );
+
+typedef struct SoftTimer_Struct
+{
+    struct SoftTimer_Struct *next;
+    struct SoftTimer_Struct **pprev;    // link pointing to this timer, NULL = not running
+    DWORD expires;                      // tick the timer expires on
+    DWORD period;                       // 0 = single shot, otherwise re-armed with period
+    SoftTimerCallback callback;         // called on expiry, may be NULL
+    BYTE expired;                       // set on expiry, cleared by SoftTimer_Expired()
+}SoftTimerStruct;
+
+
+void SoftTimer_Init();
+void SoftTimer_Start(SoftTimerStruct *t, DWORD ticks, DWORD period, SoftTimerCallback callback);
+void SoftTimer_Stop(SoftTimerStruct *t);
+BYTE SoftTimer_IsRunning(SoftTimerStruct *t);
+BYTE SoftTimer_Expired(SoftTimerStruct *t);
+
+void SoftTimer_Tick();
+BYTE SoftTimer_TicksToNextExpiry(BYTE max);
+
+#endif
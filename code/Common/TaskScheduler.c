@@ -2,30 +2,186 @@
 // (C) 2023-09-09 by Daniel Porzig
 
 #include "TaskScheduler.h"
+#include "SoftTimer.h"
 #include "HardwareProfile.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <plib.h>
 
 TaskStruct Tasks[SCHEDULER_MAX_NUM_TASKS];	
 
-// #define ENABLE_LOAD_ANALYSIS
+#ifdef SCHEDULER_PROFILING
+    TaskProfileStruct Profile[SCHEDULER_MAX_NUM_TASKS];
+#endif
+
+// background work for the rest of a tick, e.g. log output
+static IdleFnctpv IdleTask = NULL;
 
+// variables for simple load analysis
+    BYTE window = 0;
+    BYTE underrun = 0;
 
-#ifdef ENABLE_LOAD_ANALYSIS
 
-	#define TRACE_DEPTH		1024		// 1024 Samples = ~4 Sec. Recording time
+#ifdef SCHEDULER_TICKLESS
+
+// Timer4 interrupt is only used to wake the core from WAIT. the interrupt flag
+// is left set for Scheduler_Run(), so the ISR just masks the source.
+void __ISR(_TIMER_4_VECTOR, ipl1) _T4Interrupt(void)
+{
+    IEC0bits.T4IE = 0;
+}
+
+// returns the number of ticks until the next task becomes due (1 = next tick)
+static BYTE Scheduler_TicksToNextTask()
+{
+    BYTE ct;
+    DWORD skip = SCHEDULER_TICKLESS_MAX_TICKS - 1;
+
+	for(ct=0; ct< SCHEDULER_MAX_NUM_TASKS; ct++)
+	{
+        if(Tasks[ct].mPriority == 0)
+        {
+            continue;
+        }
+
+        // a ready (deferred) task has a counter of zero and needs the next
+        // tick. other tasks fire when their counter is decremented to zero
+        if(Tasks[ct].mTaskCnt == 0)
+        {
+            return 1;
+        }
+
+        if(Tasks[ct].mTaskCnt - 1 < skip)
+        {
+            skip = Tasks[ct].mTaskCnt - 1;
+        }
+    }
+
+    return skip + 1;
+}
+
+// sleep until the end of the next <ticks> scheduler ticks. all task counters
+// and the software timers are advanced by the skipped ticks so everything
+// fires on the same ticks as in busy wait mode
+static void Scheduler_Sleep(BYTE ticks)
+{
+    BYTE ct;
+    unsigned int int_status;
+
+    // extend the running tick. TMR4 keeps counting while PR4 is written, so
+    // the flag is checked again afterwards: if the old period elapsed in
+    // between, the tick is already over and nothing is skipped. otherwise
+    // TMR4 was below the old and thus below the new period
+	int_status = INTDisableInterrupts();
+    if(ticks > 1)
+    {
+        if(!IFS0bits.T4IF)
+        {
+            PR4 = (WORD)ticks * SCHEDULER_TICK_PERIOD - 1;
+        }
+        if(IFS0bits.T4IF)
+        {
+            PR4 = SCHEDULER_TICK_PERIOD - 1;
+            ticks = 1;
+        }
+    }
+    INTRestoreInterrupts(int_status);
+
+    if(ticks > 1)
+    {
+        for(ct=0; ct< SCHEDULER_MAX_NUM_TASKS; ct++)
+        {
+            if(Tasks[ct].mPriority != 0)
+            {
+                Tasks[ct].mTaskCnt -= ticks - 1;
+            }
+        }
+
+        // no timer is due on the skipped ticks, this only moves the wheel
+        for(ct=1; ct<ticks; ct++)
+        {
+            SoftTimer_Tick();
+        }
+    }
+
+    // interrupts are disabled while checking the flag, so a timer overflow
+    // between the check and WAIT can not be lost. a pending interrupt still
+    // terminates WAIT and is serviced when interrupts are restored
+	int_status = INTDisableInterrupts();
+	while(!IFS0bits.T4IF)
+	{
+        asm volatile("wait");
+        INTRestoreInterrupts(int_status);
+        int_status = INTDisableInterrupts();
+	}
+    INTRestoreInterrupts(int_status);
+}
 
-	BYTE LA_numTasks[TRACE_DEPTH];
-	WORD LA_TimeLeft[TRACE_DEPTH];
-    BYTE LA_Tasks[TRACE_DEPTH];
-	WORD LA_idx = 0;
-	
 #endif
 
-// variables for simple load analysis
-    BYTE window = 0;
-    BYTE underrun = 0;
 
+// call task and record its execution time in core timer counts (SYSCLK/2)
+static inline void Scheduler_CallTask(BYTE ct)
+{
+#ifdef SCHEDULER_PROFILING
+    TaskProfileStruct *p = &Profile[ct];
+    DWORD start, cycles;
+    BYTE late, bin;
+
+    late = IFS0bits.T4IF;
+    start = ReadCoreTimer();
+#endif
+
+    // tasks are re-armed with their period. the task may still overwrite the
+    // skiprate, a skiprate of 0 retires it
+    Tasks[ct].mTaskCnt = Tasks[ct].mPeriod;
+
+    Tasks[ct].Task(Tasks[ct].pvParameters,&Tasks[ct].mTaskCnt);
+
+    if(Tasks[ct].mTaskCnt == 0)
+    {
+        Tasks[ct].mPriority = 0;
+    }
+    // a deferred task that kept its period is re-armed from the due tick, so
+    // it does not drift. a skiprate set by the task is a delay from this call
+    else if(Tasks[ct].mTaskCnt == Tasks[ct].mPeriod && Tasks[ct].mWait > 0)
+    {
+        Tasks[ct].mTaskCnt = (Tasks[ct].mPeriod > Tasks[ct].mWait) ? Tasks[ct].mPeriod - Tasks[ct].mWait : 1;
+    }
+
+#ifdef SCHEDULER_PROFILING
+    cycles = ReadCoreTimer() - start;
+
+    p->calls++;
+    p->sum += cycles;
+    if(cycles < p->min)
+    {
+        p->min = cycles;
+    }
+    if(cycles > p->max)
+    {
+        p->max = cycles;
+    }
+
+    // this task used up the remaining time of the current tick
+    if(!late && IFS0bits.T4IF)
+    {
+        p->overruns++;
+    }
+
+    // log2 histogram, bin = floor(log2(cycles)) - SCHEDULER_PROFILE_HIST_OFFSET
+    bin = (cycles == 0) ? 0 : 31 - __builtin_clz(cycles);
+    bin = (bin > SCHEDULER_PROFILE_HIST_OFFSET) ? bin - SCHEDULER_PROFILE_HIST_OFFSET : 0;
+    if(bin >= SCHEDULER_PROFILE_HIST_BINS)
+    {
+        bin = SCHEDULER_PROFILE_HIST_BINS - 1;
+    }
+    if(p->hist[bin] != 0xFFFF)
+    {
+        p->hist[bin]++;
+    }
+#endif
+}
 
 void Scheduler_Init()
 {
@@ -33,98 +189,196 @@ void Scheduler_Init()
 	
 	// setup system timer as time reference for Task Scheduler
 	Scheduler_SetupTimer();
+
+    SoftTimer_Init();
 	
 	for(i=0; i< SCHEDULER_MAX_NUM_TASKS; i++)
 	{
 		Tasks[i].mPriority = 0;		// prio = 0 -> task will never be called
 		Tasks[i].Task = NULL;
 	}	
+
+    IdleTask = NULL;
+
+    #ifdef SCHEDULER_PROFILING
+    Scheduler_ResetProfile();
+    #endif
 }	
 
-void Scheduler_AddTask(BYTE ID, VoidFnctpv Task, void *pvParameters, BYTE prio, BYTE startdelay)
+// returns the first counter value in [first, first+span) no other task is due
+// on, so tasks added with the same start delay are spread over several ticks
+static DWORD Scheduler_FindPhase(BYTE ID, DWORD first, DWORD span)
+{
+    BYTE ct;
+    DWORD cnt;
+
+    for(cnt=first; cnt < first+span; cnt++)
+    {
+        for(ct=0; ct< SCHEDULER_MAX_NUM_TASKS; ct++)
+        {
+            if(ct != ID && Tasks[ct].mPriority != 0 && Tasks[ct].mTaskCnt == cnt)
+            {
+                break;
+            }
+        }
+
+        if(ct == SCHEDULER_MAX_NUM_TASKS)
+        {
+            return cnt;     // free tick found
+        }
+    }
+
+    return first;           // all ticks taken, no offset
+}
+
+static void Scheduler_SetupTask(BYTE ID, VoidFnctpv Task, void *pvParameters, BYTE prio, DWORD period, DWORD cnt)
 {
 	Tasks[ID].Task = Task;
 	Tasks[ID].pvParameters = pvParameters;
+	Tasks[ID].mPeriod = period;
+	Tasks[ID].mTaskCnt = cnt;
+	Tasks[ID].mDeadline = 0;
+	Tasks[ID].mWait = 0;
+	Tasks[ID].mMaxLate = 0;
+	Tasks[ID].mMissCnt = 0;
 	Tasks[ID].mPriority = prio;
-	Tasks[ID].mTaskCnt = startdelay+1;
+}
+
+// add a task that sets its own skiprate on every call. the first call is
+// placed on a free tick at most SCHEDULER_MAX_NUM_TASKS ticks after startdelay
+void Scheduler_AddTask(BYTE ID, VoidFnctpv Task, void *pvParameters, BYTE prio, DWORD startdelay)
+{
+    Scheduler_SetupTask(ID, Task, pvParameters, prio, 1,
+                        Scheduler_FindPhase(ID, startdelay+1, SCHEDULER_MAX_NUM_TASKS));
 }	
 
-void Scheduler_SetTaskSkiprate(BYTE ID, BYTE skiprate)
+// add a task that is called every <period> ticks unless it sets another
+// skiprate. the phase within the first period is chosen automatically to
+// avoid ticks already used by other tasks
+void Scheduler_AddPeriodicTask(BYTE ID, VoidFnctpv Task, void *pvParameters, BYTE prio, DWORD period)
 {
-	Tasks[ID].mTaskCnt = skiprate;
+    Scheduler_SetupTask(ID, Task, pvParameters, prio, period,
+                        Scheduler_FindPhase(ID, 1, period));
+}
+
+// call the task again after <skiprate> ticks (min. 1). tasks are retired by
+// returning a skiprate of 0 from their own call only
+void Scheduler_SetTaskSkiprate(BYTE ID, DWORD skiprate)
+{
+	Tasks[ID].mTaskCnt = (skiprate == 0) ? 1 : skiprate;
 }	
 
+// set the relative deadline: number of ticks a due task may be deferred
+// before a deadline miss is counted (default 0: must run on its due tick)
+void Scheduler_SetTaskDeadline(BYTE ID, WORD deadline)
+{
+	Tasks[ID].mDeadline = deadline;
+}
+
+// read the deadline miss counter and the longest deferral in ticks
+void Scheduler_GetDeadlineStats(BYTE ID, DWORD *misses, WORD *maxlate)
+{
+    *misses = Tasks[ID].mMissCnt;
+    *maxlate = Tasks[ID].mMaxLate;
+}
+
+// returns the ready task to run next: highest priority level first, earliest
+// deadline first within a level. if the tick is already used up (overload)
+// only realtime tasks and tasks waiting for SCHEDULER_STARVATION_BOUND ticks
+// are eligible. returns SCHEDULER_MAX_NUM_TASKS if no task is eligible
+static BYTE Scheduler_NextReadyTask(BYTE overload)
+{
+    BYTE ct, best = SCHEDULER_MAX_NUM_TASKS;
+    INT32 slack, bestslack = 0;
+
+	for(ct=0; ct< SCHEDULER_MAX_NUM_TASKS; ct++)
+	{
+        // ready tasks have a task counter of zero
+        if(Tasks[ct].mPriority == 0 || Tasks[ct].mTaskCnt != 0)
+        {
+            continue;
+        }
+
+        if(overload && Tasks[ct].mPriority < SCHEDULER_PRIO_REALTIME && Tasks[ct].mWait < SCHEDULER_STARVATION_BOUND)
+        {
+            continue;
+        }
+
+        slack = (INT32)Tasks[ct].mDeadline - Tasks[ct].mWait;
+
+        if(best == SCHEDULER_MAX_NUM_TASKS || Tasks[ct].mPriority > Tasks[best].mPriority ||
+           (Tasks[ct].mPriority == Tasks[best].mPriority && slack < bestslack))
+        {
+            best = ct;
+            bestslack = slack;
+        }
+    }
+
+    return best;
+}
+
 BYTE Scheduler_Run()
 {
-	BYTE ct,nt,tdel = 1;
+	BYTE ct;
     BYTE txt[100];
-	
-	nt = 0;
+    #ifdef SCHEDULER_TICKLESS
+    unsigned int int_status;
+    #endif
 	
 	// START SYSTEM TIMER
+    #ifdef SCHEDULER_TICKLESS
+    // single tick while tasks are running. PR4 is written before the counter
+    // is reset and without interrupts, so TMR4 can not run past the period
+    int_status = INTDisableInterrupts();
+    PR4 = SCHEDULER_TICK_PERIOD - 1;
+    #endif
+
 	TMR4=0;					// Reset Counter
 	IFS0bits.T4IF = 0;		// Reset Interrupt Flag	
-	
-	#ifdef ENABLE_LOAD_ANALYSIS	
-    LA_Tasks[LA_idx] = 0;
+
+    #ifdef SCHEDULER_TICKLESS
+    IEC0bits.T4IE = 1;                  // re-arm wake-up interrupt
+    INTRestoreInterrupts(int_status);
     #endif
 
-	
+    // expire software timers first, so tasks see their flags on this tick
+    SoftTimer_Tick();
+
+    // advance task counters. tasks that become due are ready (counter = 0),
+    // tasks deferred in an earlier tick accumulate waiting time
 	for(ct=0; ct< SCHEDULER_MAX_NUM_TASKS; ct++)
 	{
-        
-        
-        
-        
-		if(Tasks[ct].mPriority == 2)
-		{
-            // high priority task. needs to be executed right now
-			if(--Tasks[ct].mTaskCnt == 0)
-			{
-
-                #ifdef ENABLE_LOAD_ANALYSIS	
-                LA_Tasks[LA_idx] |= (1<<ct);
-                #endif
-
-
-				// call task, pass Parameters and receive new task skiprate
-				Tasks[ct].Task(Tasks[ct].pvParameters,&Tasks[ct].mTaskCnt);
-				nt++;
-			}
-//			else
-//			{
-//				Tasks[ct].mTaskCnt--;
-//			}	
-		}
-        else if(Tasks[ct].mPriority == 1)
-		{
-            // lower priority task that can be slightly delayed if no remaining cycle time available
-
-			if(--Tasks[ct].mTaskCnt == 0)
-			{
-                if(IFS0bits.T4IF)
-                {
-                    // delay task by at least one cycle
-                    Tasks[ct].mTaskCnt = tdel;
-                    tdel++;
-                }
-                else
-                {
-                    
-                    #ifdef ENABLE_LOAD_ANALYSIS	
-                    LA_Tasks[LA_idx] |= (1<<ct);
-                    #endif
-                    
-                    
-                    // call task, pass Parameters and receive new task skiprate
-                    Tasks[ct].Task(Tasks[ct].pvParameters,&Tasks[ct].mTaskCnt);
-                    nt++;
-                }
-			}
-            
+        if(Tasks[ct].mPriority == 0)
+        {
+            continue;
+        }
+
+        if(Tasks[ct].mTaskCnt == 0)
+        {
+            Tasks[ct].mWait++;
+        }
+        else if(--Tasks[ct].mTaskCnt == 0)
+        {
+            Tasks[ct].mWait = 0;
         }
-                
 	}
+
+    // run ready tasks until none is left or the tick is used up. deferred
+    // tasks stay ready and are considered again in the next tick
+    while((ct = Scheduler_NextReadyTask(IFS0bits.T4IF)) != SCHEDULER_MAX_NUM_TASKS)
+    {
+        if(Tasks[ct].mWait > Tasks[ct].mDeadline)
+        {
+            Tasks[ct].mMissCnt++;
+        }
+        if(Tasks[ct].mWait > Tasks[ct].mMaxLate)
+        {
+            Tasks[ct].mMaxLate = Tasks[ct].mWait;
+        }
+
+        // call task, pass Parameters and receive new task skiprate
+        Scheduler_CallTask(ct);
+    }
 	
 
 
@@ -153,51 +407,57 @@ BYTE Scheduler_Run()
     
     
 	
-	#ifdef ENABLE_LOAD_ANALYSIS	
-	
-		if(IFS0bits.T3IF)
-		{
-			LA_TimeLeft[LA_idx] = 0;		
-		}		
-		else
-		{
-			LA_TimeLeft[LA_idx] = TMR3;
-		}	
-			
-		LA_numTasks[LA_idx] = nt;
-		LA_idx++;
-		
-		if(LA_idx == TRACE_DEPTH)
-		{
-			// wrap around
-			LA_idx = 0;
-		}
-	
-	#endif		
+    // use the rest of the tick for background work
+    if(IdleTask != NULL)
+    {
+        while(!IFS0bits.T4IF && IdleTask())
+        {
+            ;
+        }
+    }
 			
+    #ifdef SCHEDULER_TICKLESS
+    // idle until the next task or software timer is due
+    if(!IFS0bits.T4IF)
+    {
+        Scheduler_Sleep(SoftTimer_TicksToNextExpiry(Scheduler_TicksToNextTask()));
+    }
+    #else
 	// Wait for Timer4 overflow	
 	while(!IFS0bits.T4IF)
 	{
 		;
 	}	
+    #endif
 	
 	return 0;
 }				
 				
 
+// register a function that is called repeatedly in the remaining time of
+// every tick, as long as it returns 1 (more work pending)
+void Scheduler_SetIdleTask(IdleFnctpv idle)
+{
+    IdleTask = idle;
+}
+
 void Scheduler_SetupTimer()
 {
     
     // setup timer 4 for 4ms cycle time
 	T4CON = 0x0000;
 
-	T4CONbits.TCKPS = 0b011;        // 1:8 prescale
-    PR4 = 19999;                     // 4 ms @ 40 MHz PBCLK
+	T4CONbits.TCKPS = 0b110;        // 1:64 prescale
+    PR4 = SCHEDULER_TICK_PERIOD - 1;   // 4 ms @ 40 MHz PBCLK
      
 	// Clear counter
 	TMR4 = 0;
 
+    #ifdef SCHEDULER_TICKLESS
+    IPC4bits.T4IP = 1;	// lowest priority, ISR only wakes the core from WAIT
+    #else
     IPC4bits.T4IP = 0;	// disable calling of ISR
+    #endif
     IFS0bits.T4IF = 0;
     IEC0bits.T4IE = 1;
 
@@ -206,22 +466,28 @@ void Scheduler_SetupTimer()
     
 }
 
-void Scheduler_DumpAnalysis()
+#ifdef SCHEDULER_PROFILING
+
+// copy the profiling results of a single task
+void Scheduler_GetProfile(BYTE ID, TaskProfileStruct *profile)
 {
-	#ifdef ENABLE_LOAD_ANALYSIS	
-	
-		WORD i;
-		BYTE txt[100];
-		
-		for(i=0; i<TRACE_DEPTH; i++)
-		{
-			sprintf(txt,"\n\r%5u, %5u, %5u, %3u",i,LA_TimeLeft[i],LA_numTasks[i],LA_Tasks[i]);
-			UART1_puts(txt);
-		}	
-    #else
-        //UART1_puts("\n\r error: Load analysis disabled.");
-	#endif		
-}	
+    memcpy(profile, &Profile[ID], sizeof(TaskProfileStruct));
+}
+
+// clear the profiling results of all tasks
+void Scheduler_ResetProfile()
+{
+    BYTE i;
+
+    memset(Profile, 0, sizeof(Profile));
+
+	for(i=0; i< SCHEDULER_MAX_NUM_TASKS; i++)
+	{
+        Profile[i].min = 0xFFFFFFFF;
+    }
+}
+
+#endif	
 
 
 
@@ -243,7 +509,7 @@ void Scheduler_RestoreSettings(TaskStruct *bTasks)
 
 // example Task:
 /*
-void TestTask(void *pvParameters, BYTE *skiprate)
+void TestTask(void *pvParameters, DWORD *skiprate)
 {
 	switch(BatteryADC_state)
 	{
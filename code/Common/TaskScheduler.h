@@ -12,22 +12,77 @@
 // number of simultaneous tasks
 #define SCHEDULER_MAX_NUM_TASKS		8
 
+// tickless mode: instead of busy waiting for the end of every 4 ms tick the
+// scheduler programs Timer4 up to the next due task and idles the core (WAIT).
+// the bootloader busy waits (size)
+#ifndef _BOOTLOADER_
+#define SCHEDULER_TICKLESS
+#endif
+
+// Timer4 counts per 4 ms tick (1:64 prescale @ 40 MHz PBCLK)
+#define SCHEDULER_TICK_PERIOD		2500
+
+// per-task execution time profiler based on the CP0 Count register. the
+// bootloader (_BOOTLOADER_ set in its project) is built without it
+#ifndef _BOOTLOADER_
+#define SCHEDULER_PROFILING
+#endif
+
+// log2 histogram of task execution times. bin 0 holds all runs shorter than
+// 2^(OFFSET+1) core timer counts, the last bin all runs of 2^(OFFSET+BINS-1) or more
+#define SCHEDULER_PROFILE_HIST_BINS     16
+#define SCHEDULER_PROFILE_HIST_OFFSET   5
+
+// longest sleep period in ticks that still fits into the 16 bit PR4 register
+#define SCHEDULER_TICKLESS_MAX_TICKS	(0xFFFF / SCHEDULER_TICK_PERIOD)
+
 
-typedef void (*VoidFnctpv)( void*, BYTE *);
+// priority levels 1..SCHEDULER_NUM_PRIORITIES, higher value = more important.
+// prio = 0 -> task will never be called. realtime tasks are called on their due
+// tick even if the tick is already used up, all other tasks are deferred then
+#define SCHEDULER_NUM_PRIORITIES    4
+#define SCHEDULER_PRIO_REALTIME     SCHEDULER_NUM_PRIORITIES
+
+// a deferred task is run regardless of load after waiting this many ticks
+#define SCHEDULER_STARVATION_BOUND  8
+
+
+typedef void (*VoidFnctpv)( void*, DWORD *);
+typedef BYTE (*IdleFnctpv)( void );
 
 typedef struct
 {
 	VoidFnctpv Task;
 	void *pvParameters;
-	BYTE mTaskCnt;
+	DWORD mTaskCnt;         // ticks until the next call
+	DWORD mPeriod;          // default skiprate, the task may overwrite it
+	WORD mDeadline;         // relative deadline in ticks after becoming due
+	WORD mWait;             // ticks a ready task has been deferred
+	WORD mMaxLate;          // longest deferral in ticks
+	DWORD mMissCnt;         // number of deadline misses
 	BYTE mPriority;
 }TaskStruct;	
 
+// profiling results of a single task, times in core timer counts (SYSCLK/2)
+typedef struct
+{
+    DWORD calls;
+    DWORD overruns;         // task runs that exceeded the remaining tick time
+    DWORD min;
+    DWORD max;
+    UINT64 sum;             // mean = sum / calls
+    WORD hist[SCHEDULER_PROFILE_HIST_BINS];
+}TaskProfileStruct;
+
 
 void Scheduler_Init();
-void Scheduler_AddTask(BYTE ID, VoidFnctpv Task, void *pvParameters, BYTE prio, BYTE startdelay);
-void Scheduler_SetTaskSkiprate(BYTE ID, BYTE skiprate);
+void Scheduler_AddTask(BYTE ID, VoidFnctpv Task, void *pvParameters, BYTE prio, DWORD startdelay);
+void Scheduler_AddPeriodicTask(BYTE ID, VoidFnctpv Task, void *pvParameters, BYTE prio, DWORD period);
+void Scheduler_SetTaskSkiprate(BYTE ID, DWORD skiprate);
+void Scheduler_SetTaskDeadline(BYTE ID, WORD deadline);
+void Scheduler_GetDeadlineStats(BYTE ID, DWORD *misses, WORD *maxlate);
 BYTE Scheduler_Run();
+void Scheduler_SetIdleTask(IdleFnctpv idle);
 
 void Scheduler_BackupSettings(TaskStruct *bTasks);
 void Scheduler_RestoreSettings(TaskStruct *bTasks);
@@ -35,7 +90,10 @@ void Scheduler_RestoreSettings(TaskStruct *bTasks);
 
 void Scheduler_SetupTimer();
 
-void Scheduler_DumpAnalysis();
+#ifdef SCHEDULER_PROFILING
+void Scheduler_GetProfile(BYTE ID, TaskProfileStruct *profile);
+void Scheduler_ResetProfile();
+#endif
 
 #endif
 
@@ -0,0 +1,194 @@
+// DMA driven UART transmit module
+// (C) 2023-09-09 by Daniel Porzig
+
+#include "UartDMA.h"
+#include <plib.h>
+
+typedef struct
+{
+    DmaChannel chn;
+    volatile BYTE busy;
+    UartDMASource source;
+    void *ctx;
+    UartDMACallback done;
+    BYTE *buf;              // remaining data of UartDMA_Write()
+    WORD len;
+}UartDMAStruct;
+
+static UartDMAStruct Port[UARTDMA_NUM_PORTS];
+
+
+// fetch the next block from the source and start its transfer, or finish
+static void UartDMA_NextBlock(UartDMAStruct *p, BYTE port)
+{
+    BYTE *block;
+    WORD len;
+
+    len = p->source(p->ctx, &block);
+
+    if(len == 0)
+    {
+        p->busy = 0;
+        if(p->done != NULL)
+        {
+            p->done();
+        }
+        return;
+    }
+
+    DmaChnSetTxfer(p->chn, block, (port == UARTDMA_UART1) ? (void*)&U1TXREG : (void*)&U2TXREG, len, 1, 1);
+
+    // the first cell is forced, all further cells are requested by the UART
+    DmaChnStartTxfer(p->chn, DMA_WAIT_NOT, 0);
+}
+
+static void UartDMA_Service(BYTE port)
+{
+    UartDMAStruct *p = &Port[port];
+
+    if(DmaChnGetEvFlags(p->chn) & DMA_EV_BLOCK_DONE)
+    {
+        DmaChnClrEvFlags(p->chn, DMA_EV_BLOCK_DONE);
+        UartDMA_NextBlock(p, port);
+    }
+
+    INTClearFlag(INT_SOURCE_DMA(p->chn));
+}
+
+void __ISR(_DMA0_VECTOR, ipl3) UartDMA0InterruptServiceRoutine(void)
+{
+    UartDMA_Service(UARTDMA_UART1);
+}
+
+void __ISR(_DMA1_VECTOR, ipl3) UartDMA1InterruptServiceRoutine(void)
+{
+    UartDMA_Service(UARTDMA_UART2);
+}
+
+// single buffer source of UartDMA_Write()
+static WORD UartDMA_BufferSource(void *ctx, BYTE **block)
+{
+    UartDMAStruct *p = (UartDMAStruct*)ctx;
+    WORD len = p->len;
+
+    if(len > UARTDMA_MAX_BLOCK)
+    {
+        len = UARTDMA_MAX_BLOCK;
+    }
+
+    *block = p->buf;
+    p->buf += len;
+    p->len -= len;
+
+    return len;
+}
+
+
+// setup DMA channel of a port, called by UARTxInit()
+void UartDMA_Init(BYTE port)
+{
+    UartDMAStruct *p = &Port[port];
+
+    p->chn = (port == UARTDMA_UART1) ? DMA_CHANNEL0 : DMA_CHANNEL1;
+    p->busy = 0;
+
+    DmaChnOpen(p->chn, DMA_CHN_PRI2, DMA_OPEN_DEFAULT);
+
+    // one byte is moved to the TX register on every UART TX interrupt request
+    DmaChnSetEventControl(p->chn, DMA_EV_START_IRQ_EN | DMA_EV_START_IRQ((port == UARTDMA_UART1) ? _UART1_TX_IRQ : _UART2_TX_IRQ));
+
+    DmaChnSetEvEnableFlags(p->chn, DMA_EV_BLOCK_DONE);
+
+    INTSetVectorPriority(INT_VECTOR_DMA(p->chn), INT_PRIORITY_LEVEL_3);
+    INTSetVectorSubPriority(INT_VECTOR_DMA(p->chn), INT_SUB_PRIORITY_LEVEL_0);
+    INTClearFlag(INT_SOURCE_DMA(p->chn));
+    INTEnable(INT_SOURCE_DMA(p->chn), INT_ENABLED);
+}
+
+// start a transfer. returns 0 if the port is still busy with the last one.
+// done is called (from interrupt context) when the last block was handed to
+// the UART, the last bytes may still be in the TX FIFO then
+BYTE UartDMA_Start(BYTE port, UartDMASource source, void *ctx, UartDMACallback done)
+{
+    UartDMAStruct *p = &Port[port];
+    int int_en;
+
+    // the DMA interrupt may finish the current transfer meanwhile
+    int_en = INTGetEnable(INT_SOURCE_DMA(p->chn));
+    INTEnable(INT_SOURCE_DMA(p->chn), INT_DISABLED);
+
+    if(p->busy)
+    {
+        INTEnable(INT_SOURCE_DMA(p->chn), int_en);
+        return 0;
+    }
+
+    p->busy = 1;
+    p->source = source;
+    p->ctx = ctx;
+    p->done = done;
+
+    UartDMA_NextBlock(p, port);
+
+    INTEnable(INT_SOURCE_DMA(p->chn), int_en);
+    return 1;
+}
+
+// send len bytes directly from buf (zero copy), buf must stay valid until done
+BYTE UartDMA_Write(BYTE port, BYTE *buf, WORD len, UartDMACallback done)
+{
+    UartDMAStruct *p = &Port[port];
+
+    if(p->busy)
+    {
+        return 0;
+    }
+
+    p->buf = buf;
+    p->len = len;
+
+    return UartDMA_Start(port, UartDMA_BufferSource, p, done);
+}
+
+BYTE UartDMA_IsBusy(BYTE port)
+{
+    return Port[port].busy;
+}
+
+// service the port without its interrupt, for waiting loops that may run
+// with interrupts disabled (e.g. exception handler)
+void UartDMA_Poll(BYTE port)
+{
+    UartDMAStruct *p = &Port[port];
+    int int_en;
+
+    int_en = INTGetEnable(INT_SOURCE_DMA(p->chn));
+    INTEnable(INT_SOURCE_DMA(p->chn), INT_DISABLED);
+
+    UartDMA_Service(port);
+
+    INTEnable(INT_SOURCE_DMA(p->chn), int_en);
+}
+
+// wait until the current transfer is finished
+void UartDMA_Flush(BYTE port)
+{
+    while(Port[port].busy)
+    {
+        UartDMA_Poll(port);
+    }
+}
+
+// finish all transfers and release the DMA channels (before leaving the
+// bootloader, the application has its own vector table)
+void UartDMA_Close()
+{
+    BYTE port;
+
+    for(port=0; port<UARTDMA_NUM_PORTS; port++)
+    {
+        UartDMA_Flush(port);
+        INTEnable(INT_SOURCE_DMA(Port[port].chn), INT_DISABLED);
+        DmaChnDisable(Port[port].chn);
+    }
+}
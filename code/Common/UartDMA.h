@@ -0,0 +1,42 @@
+// DMA driven UART transmit module
+// (C) 2023-09-09 by Daniel Porzig
+
+#ifndef _UARTDMA_H_
+#define _UARTDMA_H_
+
+#include <stdlib.h>
+#include "HardwareProfile.h"
+#include <GenericTypeDefs.h>
+
+// Transmission is done by one DMA channel per UART, triggered by the UART TX
+// interrupt request, so the CPU is free while the data is sent. The data is
+// handed over as a sequence of blocks: the source function is asked for the
+// next block whenever the previous one has been transferred. Blocks are sent
+// directly from the caller's memory (zero copy) and must stay valid until the
+// source function is called again. An encoder can fill a small chunk buffer
+// of its own on every call (streaming).
+//
+// NOTE: source functions and completion callbacks are called from the DMA
+// interrupt (priority level 3), they must be short and must not print.
+
+#define UARTDMA_UART1           0       // BLE module, DMA channel 0
+#define UARTDMA_UART2           1       // debug console, DMA channel 1
+#define UARTDMA_NUM_PORTS       2
+
+#define UARTDMA_MAX_BLOCK       0xFFFF  // DMA source size register is 16 bit
+
+
+// returns the length of the next block and its address in *block, 0 = done
+typedef WORD (*UartDMASource)( void *, BYTE ** );
+typedef void (*UartDMACallback)( void );
+
+
+void UartDMA_Init(BYTE port);
+BYTE UartDMA_Start(BYTE port, UartDMASource source, void *ctx, UartDMACallback done);
+BYTE UartDMA_Write(BYTE port, BYTE *buf, WORD len, UartDMACallback done);
+BYTE UartDMA_IsBusy(BYTE port);
+void UartDMA_Poll(BYTE port);
+void UartDMA_Flush(BYTE port);
+void UartDMA_Close();
+
+#endif
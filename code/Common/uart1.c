@@ -50,6 +50,9 @@ BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
 #include "HardwareProfile.h"
 #include "UART1.h"
 #include "circbuffer.h"
+#include "UartDMA.h"
+#include "Delay.h"
+#include <string.h>
 
 //******************************************************************************
 // Constants
@@ -90,8 +93,13 @@ BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
 
 
 
-static volatile CircBuffer CB_UART1RX;
-static volatile CircBuffer CB_UART1TX;
+static CircBuffer CB_UART1RX;
+static CircBuffer CB_UART1TX;
+static BYTE CB_UART1RXbuf[UART1_RX_BUFFER_SIZE];
+static BYTE CB_UART1TXbuf[CIRC_BUFFER_SIZE];
+
+static volatile DWORD UART1_rxOverruns;    // receive FIFO overruns (bytes lost in hardware)
+static volatile DWORD UART1_rxDropped;     // bytes dropped, receive buffer full
 
 
 
@@ -108,15 +116,25 @@ void __ISR(_UART_1_VECTOR, ipl5) UART1InterruptServiceRoutine(void)
 
 	
 		// put char into receive buffer
-		CircBufferWrite(&CB_UART1RX,Temp);
+		if(!CircBufferWrite(&CB_UART1RX,Temp))
+		{
+			UART1_rxDropped++;
+		}
+
+		// receive FIFO overrun, reception is stopped until OERR is cleared
+		if(U1STAbits.OERR)
+		{
+			UART1_rxOverruns++;
+			U1STAbits.OERR = 0;
+		}
 				
 		
 		// Clear the interrupt source flag
 		INTClearFlag(INT_U1RX);		
 	}
 		
-    // Transmit interrupt handling
-	if(INTGetFlag(INT_U1TX))
+    // Transmit interrupt handling (not while the TX request triggers the DMA)
+	if(INTGetEnable(INT_U1TX) && INTGetFlag(INT_U1TX))
 	{
 		// disable TX-Interrupt
    		INTEnable(INT_U1TX, INT_DISABLED);
@@ -170,39 +188,58 @@ BYTE UART1_BufIsEmpty()
 }	
 
 
+// receive error counters, since power-up or UART1_ClearRxErrors()
+DWORD UART1_GetRxOverruns()
+{
+	return UART1_rxOverruns;
+}
+
+DWORD UART1_GetRxDropped()
+{
+	return UART1_rxDropped;
+}
+
+void UART1_ClearRxErrors()
+{
+	UART1_rxOverruns = 0;
+	UART1_rxDropped = 0;
+}
+
+
 void UART1_ClearRXBuf()
 {
-    CircBufferInit(&CB_UART1RX);
+    CircBufferFlush(&CB_UART1RX);
 }
 
 void UART1_ClearTXBuf()
 {
-    CircBufferInit(&CB_UART1TX);    
+    // the TX buffer is read by the ISR, stop it while resetting
+   	INTEnable(INT_U1TX, INT_DISABLED);
+    CircBufferFlush(&CB_UART1TX);    
 }    
 
+// zero copy access to the received data, see CircBufferReadSpan()
+WORD UART1_BufReadSpan( BYTE **data )
+{
+    return CircBufferReadSpan(&CB_UART1RX, data);
+}
+
+void UART1_BufReadCommit( WORD n )
+{
+    CircBufferReadCommit(&CB_UART1RX, n);
+}
+
 
 
 char UART1_BufRead()
 {
-    char temp;
-    
-    // disable TX-Interrupt
-   	INTEnable(INT_U1RX, INT_DISABLED);
-    
-    temp = (CircBufferRead(&CB_UART1RX));
-    
-    // re-enable TX-Interrupt
-   	INTEnable(INT_U1RX, INT_ENABLED);    
-        
-	return temp;
+    // single consumer, the RX interrupt can stay enabled
+	return CircBufferRead(&CB_UART1RX);
 }	
 
 void UART1_BufPutChar( char ch )
 {
-    // disable TX-Interrupt
-   	INTEnable(INT_U1TX, INT_DISABLED);
-
-    // put the char into the transmit buffer
+    // put the char into the transmit buffer (dropped if full)
     CircBufferWrite(&CB_UART1TX,ch);
 
 /*
@@ -219,7 +256,7 @@ void UART1_BufPutChar( char ch )
     }
 */
     
-    // reenable TX-Interrupt
+    // (re)start TX-Interrupt
    	INTEnable(INT_U1TX, INT_ENABLED);
     
 }
@@ -246,6 +283,195 @@ void UART1_BufPrintString( char *str )
 
 
 
+// HM-17 baud rate negotiation
+//
+// The module keeps its UART rate in its own flash. On power-up the current
+// rate is searched by sending "AT" at all supported rates, then the module is
+// switched to the fastest rate up to BAUDRATE_UART1_MAX (AT+BAUDx, AT+RESET)
+// and U1BRG is changed to match. If the module does not answer at the new
+// rate, the last working rate is used again. Connection notifications are
+// enabled on the way (AT+NOTI1, see BTComLinkCallback).
+// NOTE: "AT" drops an active BLE connection, so the negotiation must only run
+// while no host is connected (power-up, console command).
+
+typedef struct
+{
+    DWORD baud;
+    char code;          // AT+BAUD parameter
+}HM17BaudStruct;
+
+// fastest first
+static const HM17BaudStruct HM17_baudrates[] =
+{
+    {230400, '8'},
+    {115200, '4'},
+    { 57600, '3'},
+    { 38400, '2'},
+    { 19200, '1'},
+    {  9600, '0'},
+};
+
+#define HM17_NUM_BAUDRATES      (sizeof(HM17_baudrates) / sizeof(HM17BaudStruct))
+
+#define HM17_RESPONSE_TIMEOUT   100     // ms, response to an AT command
+#define HM17_RESET_TIME         800     // ms, module restart after AT+RESET
+
+static DWORD UART1_baudrate = BAUDRATE_UART1;
+
+
+// set UART1 rate at runtime (high speed mode, BRG_DIV 4)
+void UART1SetBaudrate( DWORD baud )
+{
+    UartDMA_Flush(UARTDMA_UART1);
+    while(U1STAbits.TRMT == 0);
+
+    U1MODEbits.BRGH = 1;
+    U1BRG = (GetPeripheralClock() + 2*baud) / (4*baud) - 1;
+
+    UART1_baudrate = baud;
+}
+
+DWORD UART1GetBaudrate()
+{
+    return UART1_baudrate;
+}
+
+// send an AT command and check that the response starts with <expect>
+static BYTE UART1_HM17Command( char *cmd, char *expect )
+{
+    char resp[16];
+    BYTE n = 0;
+    WORD t;
+
+    CircBufferFlush(&CB_UART1RX);
+    UART1PrintString(cmd);
+
+    // collect the response until the line is quiet for a while
+    for(t=0; t<HM17_RESPONSE_TIMEOUT; t++)
+    {
+        Delayms(1);
+
+        while(!CircBufferIsEmpty(&CB_UART1RX))
+        {
+            resp[n] = CircBufferRead(&CB_UART1RX);
+            if(n < sizeof(resp)-1)
+            {
+                n++;
+            }
+            t = HM17_RESPONSE_TIMEOUT - 10;     // 10 ms after the last byte
+        }
+    }
+    resp[n] = 0;
+
+    return (strncmp(resp, expect, strlen(expect)) == 0);
+}
+
+// search the rate the module is currently using, starting with <hint>.
+// returns the table index, HM17_NUM_BAUDRATES = module does not answer
+static BYTE UART1_HM17FindBaudrate( DWORD hint )
+{
+    BYTE i;
+
+    UART1SetBaudrate(hint);
+    if(UART1_HM17Command("AT", "OK"))
+    {
+        for(i=0; i<HM17_NUM_BAUDRATES; i++)
+        {
+            if(HM17_baudrates[i].baud == hint)
+            {
+                return i;
+            }
+        }
+    }
+
+    for(i=0; i<HM17_NUM_BAUDRATES; i++)
+    {
+        UART1SetBaudrate(HM17_baudrates[i].baud);
+        if(UART1_HM17Command("AT", "OK"))
+        {
+            return i;
+        }
+    }
+
+    return HM17_NUM_BAUDRATES;
+}
+
+// use a rate found by an earlier negotiation without talking to the module
+// (keeps an active connection). returns 0 if <baud> is no valid rate
+BYTE UART1_HM17UseBaudrate( DWORD baud )
+{
+    BYTE i;
+
+    for(i=0; i<HM17_NUM_BAUDRATES; i++)
+    {
+        if(HM17_baudrates[i].baud == baud && baud <= BAUDRATE_UART1_MAX)
+        {
+            UART1SetBaudrate(baud);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// switch the module to the fastest supported rate, <hint> = last known rate.
+// returns the rate in use, 0 if the module does not answer (UART1 is set back
+// to BAUDRATE_UART1 then)
+DWORD UART1_HM17Negotiate( DWORD hint )
+{
+    char cmd[10] = "AT+BAUDx";
+    BYTE cur, i;
+
+    cur = UART1_HM17FindBaudrate(hint);
+    if(cur == HM17_NUM_BAUDRATES)
+    {
+        UART1SetBaudrate(BAUDRATE_UART1);
+        return 0;
+    }
+
+    // report connect / disconnect to the host side ("OK+CONN", "OK+LOST"),
+    // kept in the module flash like the rate
+    UART1_HM17Command("AT+NOTI1", "OK+Set");
+
+    // try the faster rates, fastest first
+    for(i=0; i<cur; i++)
+    {
+        if(HM17_baudrates[i].baud > BAUDRATE_UART1_MAX)
+        {
+            continue;
+        }
+
+        cmd[7] = HM17_baudrates[i].code;
+        if(!UART1_HM17Command(cmd, "OK+Set"))
+        {
+            continue;   // rate not supported by this module
+        }
+
+        // the new rate is used after a restart of the module
+        UART1_HM17Command("AT+RESET", "OK+RESET");
+        Delayms(HM17_RESET_TIME);
+
+        UART1SetBaudrate(HM17_baudrates[i].baud);
+        if(UART1_HM17Command("AT", "OK"))
+        {
+            return HM17_baudrates[i].baud;
+        }
+
+        // module does not answer at the new rate, go back to the working one
+        cur = UART1_HM17FindBaudrate(HM17_baudrates[cur].baud);
+        if(cur == HM17_NUM_BAUDRATES)
+        {
+            UART1SetBaudrate(BAUDRATE_UART1);
+            return 0;
+        }
+    }
+
+    UART1SetBaudrate(HM17_baudrates[cur].baud);
+    return HM17_baudrates[cur].baud;
+}
+
+
+
 
 
 
@@ -360,10 +586,12 @@ void UART1Init()
 	INTEnable(INT_U1TX, INT_DISABLED);
 
 
-    CircBufferInit(&CB_UART1RX);
-    CircBufferInit(&CB_UART1TX);    
+    CircBufferInit(&CB_UART1RX, CB_UART1RXbuf, sizeof(CB_UART1RXbuf));
+    CircBufferInit(&CB_UART1TX, CB_UART1TXbuf, sizeof(CB_UART1TXbuf));    
 
     U1STAbits.URXEN = 1;
+
+    UartDMA_Init(UARTDMA_UART1);
 }
 
 /*******************************************************************************
@@ -433,6 +661,9 @@ Output: None.
 *******************************************************************************/
 void UART1PutChar( char ch )
 {
+    // keep the order of a running DMA transfer
+    UartDMA_Flush(UARTDMA_UART1);
+
     U1TXREG = ch;
     #if !defined(__PIC32MX__)
         Nop();
@@ -48,6 +48,8 @@ BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
 // Function Prototypes
 //******************************************************************************
 
+// receive ring, large enough to queue a window of BTCom v2 request frames
+#define UART1_RX_BUFFER_SIZE    1024
 
 
 
@@ -58,6 +60,16 @@ void UART1_BufPrintString( char *str );
 void UART1_ClearRXBuf();
 void UART1_ClearTXBuf();
 
+void UART1SetBaudrate( DWORD baud );
+DWORD UART1GetBaudrate();
+BYTE UART1_HM17UseBaudrate( DWORD baud );
+DWORD UART1_HM17Negotiate( DWORD hint );
+WORD UART1_BufReadSpan( BYTE **data );
+DWORD UART1_GetRxOverruns();
+DWORD UART1_GetRxDropped();
+void UART1_ClearRxErrors();
+void UART1_BufReadCommit( WORD n );
+
 
 
 
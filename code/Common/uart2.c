@@ -50,6 +50,7 @@ BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
 #include "HardwareProfile.h"
 #include "UART2.h"
 #include "circbuffer.h"
+#include "UartDMA.h"
 
 //******************************************************************************
 // Constants
@@ -90,8 +91,19 @@ BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
 
 
 
-static volatile CircBuffer CB_UART2RX;
-static volatile CircBuffer CB_UART2TX;
+static CircBuffer CB_UART2RX;
+static CircBuffer CB_UART2TX;
+static BYTE CB_UART2RXbuf[CIRC_BUFFER_SIZE];
+static BYTE CB_UART2TXbuf[CIRC_BUFFER_SIZE];
+
+// DMA transmit ring of UART2_DMAPrintString(), free running indices
+#define UART2_TXRING_SIZE       512     // power of 2
+#define UART2_TXRING_MASK       (UART2_TXRING_SIZE - 1)
+
+static BYTE UART2_txring[UART2_TXRING_SIZE];
+static volatile WORD UART2_txhead = 0;
+static volatile WORD UART2_txtail = 0;
+static WORD UART2_txblock = 0;          // length of the block in transfer
 
 
 
@@ -115,8 +127,8 @@ void __ISR(_UART_2_VECTOR, ipl5) UART2InterruptServiceRoutine(void)
 		INTClearFlag(INT_U2RX);		
 	}
 		
-    // Transmit interrupt handling
-	if(INTGetFlag(INT_U2TX))
+    // Transmit interrupt handling (not while the TX request triggers the DMA)
+	if(INTGetEnable(INT_U2TX) && INTGetFlag(INT_U2TX))
 	{
 		// disable TX-Interrupt
    		INTEnable(INT_U2TX, INT_DISABLED);
@@ -172,37 +184,38 @@ BYTE UART2_BufIsEmpty()
 
 void UART2_ClearRXBuf()
 {
-    CircBufferInit(&CB_UART2RX);
+    CircBufferFlush(&CB_UART2RX);
 }
 
 void UART2_ClearTXBuf()
 {
-    CircBufferInit(&CB_UART2TX);    
+    // the TX buffer is read by the ISR, stop it while resetting
+   	INTEnable(INT_U2TX, INT_DISABLED);
+    CircBufferFlush(&CB_UART2TX);    
 }    
 
+// zero copy access to the received data, see CircBufferReadSpan()
+WORD UART2_BufReadSpan( BYTE **data )
+{
+    return CircBufferReadSpan(&CB_UART2RX, data);
+}
+
+void UART2_BufReadCommit( WORD n )
+{
+    CircBufferReadCommit(&CB_UART2RX, n);
+}
+
 
 
 char UART2_BufRead()
 {
-    char temp;
-    
-    // disable TX-Interrupt
-   	INTEnable(INT_U2RX, INT_DISABLED);
-    
-    temp = (CircBufferRead(&CB_UART2RX));
-    
-    // re-enable TX-Interrupt
-   	INTEnable(INT_U2RX, INT_ENABLED);    
-        
-	return temp;
+    // single consumer, the RX interrupt can stay enabled
+	return CircBufferRead(&CB_UART2RX);
 }	
 
 void UART2_BufPutChar( char ch )
 {
-    // disable TX-Interrupt
-   	INTEnable(INT_U2TX, INT_DISABLED);
-
-    // put the char into the transmit buffer
+    // put the char into the transmit buffer (dropped if full)
     CircBufferWrite(&CB_UART2TX,ch);
 
 /*
@@ -219,7 +232,7 @@ void UART2_BufPutChar( char ch )
     }
 */
     
-    // reenable TX-Interrupt
+    // (re)start TX-Interrupt
    	INTEnable(INT_U2TX, INT_ENABLED);
     
 }
@@ -245,6 +258,75 @@ void UART2_BufPrintString( char *str )
 }
 
 
+// DMA source of the transmit ring: releases the block sent last and returns
+// the next contiguous part of the ring (sent in place, no copy)
+static WORD UART2_TxRingSource(void *ctx, BYTE **block)
+{
+    WORD len, ofs;
+
+    UART2_txtail += UART2_txblock;
+
+    len = UART2_txhead - UART2_txtail;
+    ofs = UART2_txtail & UART2_TXRING_MASK;
+
+    if(len > UART2_TXRING_SIZE - ofs)
+    {
+        len = UART2_TXRING_SIZE - ofs;
+    }
+
+    UART2_txblock = len;
+    *block = &UART2_txring[ofs];
+
+    return len;
+}
+
+static void UART2_TxRingPut( BYTE c )
+{
+    while((WORD)(UART2_txhead - UART2_txtail) >= UART2_TXRING_SIZE)
+    {
+        UartDMA_Poll(UARTDMA_UART2);
+    }
+
+    UART2_txring[UART2_txhead & UART2_TXRING_MASK] = c;
+
+    // the char must be in the ring before the DMA interrupt may see it
+    asm volatile("" ::: "memory");
+    UART2_txhead++;
+}
+
+// non-blocking print: the string is put into the transmit ring and sent by
+// DMA. only waits if the ring is full
+void UART2_DMAPrintString( char *str )
+{
+    unsigned char c;
+
+    while( (c = *str++) )
+    {
+        UART2_TxRingPut(c);
+    }
+
+    // does nothing if the transfer is still running, it picks up the new data
+    UartDMA_Start(UARTDMA_UART2, UART2_TxRingSource, NULL, NULL);
+}
+
+// non-blocking write of binary data, see UART2_DMAPrintString()
+void UART2_DMAWrite( BYTE *buf, WORD len )
+{
+    while(len--)
+    {
+        UART2_TxRingPut(*buf++);
+    }
+
+    UartDMA_Start(UARTDMA_UART2, UART2_TxRingSource, NULL, NULL);
+}
+
+// free space in the transmit ring
+WORD UART2_DMATxFree()
+{
+    return UART2_TXRING_SIZE - (WORD)(UART2_txhead - UART2_txtail);
+}
+
+
 
 
 
@@ -360,10 +442,12 @@ void UART2Init()
 	INTEnable(INT_U2TX, INT_DISABLED);
 
 
-    CircBufferInit(&CB_UART2RX);
-    CircBufferInit(&CB_UART2TX);    
+    CircBufferInit(&CB_UART2RX, CB_UART2RXbuf, sizeof(CB_UART2RXbuf));
+    CircBufferInit(&CB_UART2TX, CB_UART2TXbuf, sizeof(CB_UART2TXbuf));    
 
     U2STAbits.URXEN = 1;
+
+    UartDMA_Init(UARTDMA_UART2);
 }
 
 /*******************************************************************************
@@ -433,6 +517,9 @@ Output: None.
 *******************************************************************************/
 void UART2PutChar( char ch )
 {
+    // keep the order of a running DMA transfer
+    UartDMA_Flush(UARTDMA_UART2);
+
     U2TXREG = ch;
     #if !defined(__PIC32MX__)
         Nop();
@@ -57,6 +57,11 @@ void UART2_BufPutChar( char ch );
 void UART2_BufPrintString( char *str );
 void UART2_ClearRXBuf();
 void UART2_ClearTXBuf();
+WORD UART2_BufReadSpan( BYTE **data );
+void UART2_BufReadCommit( WORD n );
+void UART2_DMAPrintString( char *str );
+void UART2_DMAWrite( BYTE *buf, WORD len );
+WORD UART2_DMATxFree();
 
 
 
@@ -0,0 +1,114 @@
+// BTComDecoder / CRC16 host throughput benchmark: a stream of v2 frames is
+// decoded in UART receive spans like BTCom_Task() does (CRC checked at ETX),
+// and CRC16_Update() is run over the raw data.
+// (C) 2023-09-09 by Daniel Porzig
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "BTComDecoder.h"
+#include "CRC16.h"
+
+#define BENCH_BYTES         (32UL << 20)
+#define BENCH_PAYLOAD       64          // seq cmd data..., typical request
+#define BENCH_FRAMES        64          // frames in the stream buffer
+#define BENCH_SPAN          64          // receive span handed to Feed()
+
+// cycle counter of the host, nanoseconds where no counter is available
+static inline UINT64 Bench_Cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (UINT64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static WORD Bench_Put(BYTE *out, WORD n, BYTE b)
+{
+    if(b == STX || b == ETX || b == DLE)
+    {
+        out[n++] = DLE;
+    }
+    out[n++] = b;
+    return n;
+}
+
+static BYTE stream[BENCH_FRAMES * (2*BENCH_PAYLOAD + 8)];
+
+static void Bench_Report(const char *name, UINT64 bytes, UINT64 cycles, const char *note)
+{
+    printf("%-28s %8.3f bytes/cycle %8.2f cycles/byte%s\n", name,
+           (double)bytes / cycles, (double)cycles / bytes, note);
+}
+
+int main(void)
+{
+    static BYTE buf[2*BENCH_PAYLOAD];
+    BTComDecoderStruct dec;
+    UINT64 t, bytes;
+    DWORD n = 0, pos, frames = 0, errors = 0;
+    WORD i, f, crc, used, span;
+    BYTE payload[BENCH_PAYLOAD];
+    BYTE status;
+    volatile WORD sink = 0;
+
+    // stream of v2 frames, random data includes the control bytes
+    for(f=0; f<BENCH_FRAMES; f++)
+    {
+        for(i=0; i<BENCH_PAYLOAD; i++)
+        {
+            payload[i] = (BYTE)((f * 131 + i * 29) ^ (i >> 2));
+        }
+        crc = CRC16_Update(CRC16_INIT, payload, BENCH_PAYLOAD);
+
+        stream[n++] = STX;
+        stream[n++] = STX2;
+        for(i=0; i<BENCH_PAYLOAD; i++)
+        {
+            n = Bench_Put(stream, n, payload[i]);
+        }
+        n = Bench_Put(stream, n, crc >> 8);
+        n = Bench_Put(stream, n, crc & 0xFF);
+        stream[n++] = ETX;
+    }
+
+    // decoder, spans of the receive buffer
+    BTComDecoder_Init(&dec, buf, sizeof(buf));
+    bytes = 0;
+    t = Bench_Cycles();
+    while(bytes < BENCH_BYTES)
+    {
+        for(pos=0; pos<n; pos+=used)
+        {
+            span = (n - pos < BENCH_SPAN) ? n - pos : BENCH_SPAN;
+            used = BTComDecoder_Feed(&dec, &stream[pos], span, &status);
+            if(status == BTCOMDEC_DONE)
+            {
+                frames++;
+            }
+            else if(status != BTCOMDEC_NONE)
+            {
+                errors++;
+            }
+        }
+        bytes += n;
+    }
+    Bench_Report("BTComDecoder_Feed, v2", bytes, Bench_Cycles() - t, errors ? "  DECODE ERRORS" : "");
+
+    // CRC16 alone
+    bytes = 0;
+    t = Bench_Cycles();
+    while(bytes < BENCH_BYTES)
+    {
+        sink ^= CRC16_Update(CRC16_INIT, stream, n);
+        bytes += n;
+    }
+    Bench_Report("CRC16_Update", bytes, Bench_Cycles() - t, "");
+
+    printf("%lu frames decoded\n", (unsigned long)frames);
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,200 @@
+// BTComDecoder fuzz test, built with ASan/UBSan: random and mutated v1/v2
+// frames are fed in random chunks into a decoder with an exactly sized heap
+// buffer. Valid frames must decode to their payload, the decoder must never
+// write beyond its buffer and Feed() must always make progress.
+// "btcomdec_fuzz <iterations> <seed>", defaults below
+// (C) 2023-09-09 by Daniel Porzig
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "BTComDecoder.h"
+#include "CRC16.h"
+
+#define FUZZ_ITERATIONS     200000
+#define FUZZ_MAX_PAYLOAD    300
+#define FUZZ_MAX_STREAM     (2*FUZZ_MAX_PAYLOAD + 16)
+
+static DWORD rnd;
+static DWORD errors;
+
+static DWORD Fuzz_Rand(void)
+{
+    rnd = rnd * 1103515245 + 12345;
+    return (rnd >> 8) & 0xFFFFFF;
+}
+
+static WORD Fuzz_Put(BYTE *out, WORD n, BYTE b)
+{
+    if(b == STX || b == ETX || b == DLE)
+    {
+        out[n++] = DLE;
+    }
+    out[n++] = b;
+    return n;
+}
+
+// encode <len> payload bytes as a frame, returns the stream length.
+// v1 payload: cmd data..., v2 payload: seq cmd data...
+static WORD Fuzz_Encode(BYTE *out, BYTE *payload, WORD len, BYTE version)
+{
+    WORD n = 0, i, crc;
+    BYTE sum = 0;
+
+    out[n++] = STX;
+    out[n++] = (version == 2) ? STX2 : STX;
+    for(i=0; i<len; i++)
+    {
+        n = Fuzz_Put(out, n, payload[i]);
+        sum += payload[i];
+    }
+    if(version == 2)
+    {
+        crc = CRC16_Update(CRC16_INIT, payload, len);
+        n = Fuzz_Put(out, n, crc >> 8);
+        n = Fuzz_Put(out, n, crc & 0xFF);
+    }
+    else
+    {
+        n = Fuzz_Put(out, n, (BYTE)-sum);
+    }
+    out[n++] = ETX;
+    return n;
+}
+
+static void Fuzz_Error(DWORD it, const char *what)
+{
+    if(errors++ < 10)
+    {
+        printf("iteration %lu: %s\n", (unsigned long)it, what);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static BYTE payload[FUZZ_MAX_PAYLOAD];
+    static BYTE stream[FUZZ_MAX_STREAM];
+    BTComDecoderStruct dec;
+    BYTE *buf;
+    DWORD it, iterations = FUZZ_ITERATIONS;
+    DWORD streams = 0, decoded = 0, rejected = 0;
+    WORD len, n, size, i, pos, chunk, used, expect;
+    BYTE version, mutate, status, first, valid;
+
+    if(argc > 1)
+    {
+        iterations = strtoul(argv[1], NULL, 0);
+    }
+    rnd = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+
+    for(it=0; it<iterations; it++)
+    {
+        version = 1 + Fuzz_Rand() % 2;
+        len = version + Fuzz_Rand() % (FUZZ_MAX_PAYLOAD - 2);
+        for(i=0; i<len; i++)
+        {
+            // favour the control bytes
+            payload[i] = (Fuzz_Rand() % 4 == 0) ? STX + Fuzz_Rand() % 3 : Fuzz_Rand();
+        }
+        n = Fuzz_Encode(stream, payload, len, version);
+
+        // decoded size: v2 keeps buf[0] free, plus the trailer
+        expect = len + ((version == 2) ? 3 : 1);
+        // buffer fits the frame exactly or more, or random (too small)
+        size = (Fuzz_Rand() % 2) ? expect + Fuzz_Rand() % 4 : 1 + Fuzz_Rand() % (expect + 8);
+
+        // 3 of 8 streams are damaged: random bytes, truncation or garbage
+        mutate = Fuzz_Rand() % 8;
+        valid = (mutate == 0 || mutate > 3);
+        if(mutate == 1)
+        {
+            for(i=Fuzz_Rand() % 4; i<4; i++)
+            {
+                stream[Fuzz_Rand() % n] = Fuzz_Rand();
+            }
+        }
+        else if(mutate == 2)
+        {
+            n = Fuzz_Rand() % n;
+        }
+        else if(mutate == 3)
+        {
+            n = Fuzz_Rand() % FUZZ_MAX_STREAM;
+            for(i=0; i<n; i++)
+            {
+                stream[i] = (Fuzz_Rand() % 2) ? Fuzz_Rand() : STX + Fuzz_Rand() % 3;
+            }
+        }
+
+        // exactly sized, ASan reports any access beyond
+        buf = malloc(size);
+        BTComDecoder_Init(&dec, buf, size);
+        streams++;
+        first = BTCOMDEC_NONE;
+
+        for(pos=0; pos<n; pos+=used)
+        {
+            chunk = 1 + Fuzz_Rand() % (n - pos);
+            used = BTComDecoder_Feed(&dec, &stream[pos], chunk, &status);
+
+            if(used == 0 || used > chunk)
+            {
+                Fuzz_Error(it, "Feed() consumed no or too many bytes");
+                break;
+            }
+            if(dec.count > size || dec.state > BTCOMDEC_STATE_DLE)
+            {
+                Fuzz_Error(it, "decoder state out of range");
+                break;
+            }
+            if(status == BTCOMDEC_NONE)
+            {
+                if(used != chunk)
+                {
+                    Fuzz_Error(it, "Feed() stopped without result");
+                }
+                continue;
+            }
+
+            // the rest of a valid but oversized frame may look like a frame
+            if(first == BTCOMDEC_NONE)
+            {
+                first = status;
+            }
+            else
+            {
+                valid = 0;
+            }
+
+            if(status == BTCOMDEC_DONE)
+            {
+                decoded++;
+                if(valid && (dec.version != version || dec.count != expect ||
+                   memcmp(&buf[version - 1], payload, len) != 0))
+                {
+                    Fuzz_Error(it, "frame decoded wrong");
+                }
+            }
+            else
+            {
+                rejected++;
+                if(valid && !(status == BTCOMDEC_ERR_SIZE && size < expect))
+                {
+                    Fuzz_Error(it, "valid frame rejected");
+                }
+            }
+        }
+
+        if(valid && size >= expect && first != BTCOMDEC_DONE)
+        {
+            Fuzz_Error(it, "valid frame not completed");
+        }
+
+        free(buf);
+    }
+
+    printf("%lu streams, %lu frames decoded, %lu rejected, %lu errors\n", (unsigned long)streams,
+           (unsigned long)decoded, (unsigned long)rejected, (unsigned long)errors);
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,164 @@
+// CircBuffer host microbenchmark: bytes per cycle of the previous ring (shared
+// BYTE count, interrupt source masked around every byte as UART1_BufRead()
+// and UART1_BufPutChar() did) against the SPSC ring, per byte and via spans.
+// Producer and consumer alternate in blocks like the UART ISR and the task.
+// (C) 2023-09-09 by Daniel Porzig
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "CircBuffer.h"
+
+#define BENCH_BYTES         (64UL << 20)
+#define BENCH_BLOCK         64
+
+// cycle counter of the host, nanoseconds where no counter is available
+static inline UINT64 Bench_Cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (UINT64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+
+// previous implementation (baseline CircBuffer.c)
+typedef struct
+{
+    BYTE buffer[CIRC_BUFFER_SIZE];
+    BYTE *read;
+    BYTE *write;
+    BYTE count;
+}LegacyBuffer;
+
+static volatile DWORD Legacy_IEC;
+
+// INTEnable() of the UART source, a read-modify-write of an SFR
+static void __attribute__((noinline)) Legacy_IntEnable(BYTE on)
+{
+    Legacy_IEC = on ? (Legacy_IEC | 1) : (Legacy_IEC & ~1);
+}
+
+static void __attribute__((noinline)) Legacy_Write(LegacyBuffer *CB, BYTE val)
+{
+    Legacy_IntEnable(0);
+    *CB->write = val;
+    CB->write++;
+    if(CB->write >= (CB->buffer + CIRC_BUFFER_SIZE))
+    {
+        CB->write = CB->buffer;
+    }
+    CB->count++;
+    Legacy_IntEnable(1);
+}
+
+static BYTE __attribute__((noinline)) Legacy_Read(LegacyBuffer *CB)
+{
+    BYTE t;
+
+    Legacy_IntEnable(0);
+    t = *CB->read;
+    CB->read++;
+    if(CB->read >= (CB->buffer + CIRC_BUFFER_SIZE))
+    {
+        CB->read = CB->buffer;
+    }
+    CB->count--;
+    Legacy_IntEnable(1);
+    return t;
+}
+
+
+static BYTE src[BENCH_BLOCK];
+
+static void Bench_Report(const char *name, UINT64 cycles, DWORD sum, DWORD ref)
+{
+    printf("%-28s %8.3f bytes/cycle %8.2f cycles/byte%s\n", name,
+           (double)BENCH_BYTES / cycles, (double)cycles / BENCH_BYTES,
+           (sum == ref) ? "" : "  DATA MISMATCH");
+}
+
+int main(void)
+{
+    static LegacyBuffer legacy;
+    static BYTE storage[CIRC_BUFFER_SIZE];
+    CircBuffer cb;
+    UINT64 t;
+    DWORD pos, i, n, sum, ref = 0;
+    WORD span, k;
+    BYTE *p;
+
+    for(i=0; i<BENCH_BLOCK; i++)
+    {
+        src[i] = (BYTE)(i * 7 + 3);
+        ref += src[i];
+    }
+    ref *= BENCH_BYTES / BENCH_BLOCK;
+
+    // previous ring
+    legacy.read = legacy.write = legacy.buffer;
+    legacy.count = 0;
+    sum = 0;
+    t = Bench_Cycles();
+    for(pos=0; pos<BENCH_BYTES; pos+=BENCH_BLOCK)
+    {
+        for(i=0; i<BENCH_BLOCK; i++)
+        {
+            Legacy_Write(&legacy, src[i]);
+        }
+        for(i=0; i<BENCH_BLOCK; i++)
+        {
+            sum += Legacy_Read(&legacy);
+        }
+    }
+    Bench_Report("previous, per byte", Bench_Cycles() - t, sum, ref);
+
+    // SPSC ring, byte API
+    CircBufferInit(&cb, storage, sizeof(storage));
+    sum = 0;
+    t = Bench_Cycles();
+    for(pos=0; pos<BENCH_BYTES; pos+=BENCH_BLOCK)
+    {
+        for(i=0; i<BENCH_BLOCK; i++)
+        {
+            CircBufferWrite(&cb, src[i]);
+        }
+        while(!CircBufferIsEmpty(&cb))
+        {
+            sum += CircBufferRead(&cb);
+        }
+    }
+    Bench_Report("SPSC, per byte", Bench_Cycles() - t, sum, ref);
+
+    // SPSC ring, spans (consumer parses in place like BTCom_Task)
+    CircBufferInit(&cb, storage, sizeof(storage));
+    sum = 0;
+    t = Bench_Cycles();
+    for(pos=0; pos<BENCH_BYTES; pos+=BENCH_BLOCK)
+    {
+        for(i=0; i<BENCH_BLOCK; i+=n)
+        {
+            n = CircBufferWriteSpan(&cb, &p);
+            if(n > BENCH_BLOCK - i)
+            {
+                n = BENCH_BLOCK - i;
+            }
+            memcpy(p, &src[i], n);
+            CircBufferWriteCommit(&cb, n);
+        }
+        while((span = CircBufferReadSpan(&cb, &p)) != 0)
+        {
+            for(k=0; k<span; k++)
+            {
+                sum += p[k];
+            }
+            CircBufferReadCommit(&cb, span);
+        }
+    }
+    Bench_Report("SPSC, spans", Bench_Cycles() - t, sum, ref);
+
+    return 0;
+}
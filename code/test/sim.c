@@ -0,0 +1,136 @@
+// simulated PIC32 timer hardware for the host tests
+// (C) 2023-09-09 by Daniel Porzig
+//
+// Timer4 matches PR4, resets and sets T4IF like the real timer. A match with
+// T4IF still set would be a lost tick, interrupts are shortened so that this
+// does not happen: the tests assume the 4 ms budget is kept. Every match adds
+// the full ticks of the elapsed counts to the wall clock Sim.ticks, so a tick
+// that was extended too late or an overshot PR4 shows up as a wrong tick.
+
+#include "sim.h"
+
+SimStruct Sim;
+
+volatile DWORD Sim_TMR4, Sim_PR4, Sim_T4CON;
+volatile SimIEC0bits Sim_IEC0;
+volatile SimIPC4bits Sim_IPC4;
+volatile SimT4CONbits Sim_T4CONbits;
+
+static volatile SimIFS0bits Sim_IFS0bits;
+static DWORD Sim_core;
+static DWORD Sim_seed;
+static BYTE Sim_intEnabled;
+
+DWORD Sim_Rand(void)
+{
+    Sim_seed = Sim_seed * 1103515245 + 12345;
+    return Sim_seed >> 8;
+}
+
+// advance Timer4 by <counts>
+static void Sim_Advance(DWORD counts)
+{
+    Sim_core += counts * SIM_CORE_PER_T4;
+
+    while(counts-- > 0)
+    {
+        Sim.count++;
+
+        if(Sim_TMR4 == Sim_PR4)
+        {
+            Sim.ticks += Sim.count / SIM_TICK_PERIOD;
+            Sim.matches++;
+            if(Sim.count > SIM_TICK_PERIOD)
+            {
+                Sim.longMatches++;
+            }
+            Sim.count = 0;
+            Sim_TMR4 = 0;
+            Sim_IFS0bits.T4IF = 1;
+        }
+        else
+        {
+            Sim_TMR4 = (Sim_TMR4 + 1) & 0xFFFF;
+        }
+    }
+}
+
+// time spent by a single register access, sometimes an interrupt is taken
+static void Sim_Step(void)
+{
+    DWORD n = 1 + Sim_Rand() % 2;
+
+    if(Sim_intEnabled && Sim.isrRate != 0 && Sim_Rand() % Sim.isrRate == 0)
+    {
+        n += Sim_Rand() % Sim.isrMax;
+        Sim.isrs++;
+    }
+
+    // the scheduler sees a match within one tick, otherwise ticks are lost in
+    // busy wait mode as well
+    if(Sim_IFS0bits.T4IF && Sim_TMR4 + n >= SIM_TICK_PERIOD - 1)
+    {
+        n = (Sim_TMR4 < SIM_TICK_PERIOD - 1) ? SIM_TICK_PERIOD - 1 - Sim_TMR4 - 1 : 0;
+    }
+
+    Sim_Advance(n);
+}
+
+void Sim_Init(DWORD seed, DWORD isrRate, DWORD isrMax)
+{
+    memset(&Sim, 0, sizeof(Sim));
+    Sim.isrRate = isrRate;
+    Sim.isrMax = isrMax;
+    Sim_seed = seed;
+    Sim_TMR4 = 0;
+    Sim_PR4 = 0xFFFF;
+    Sim_IFS0bits.T4IF = 0;
+    Sim_intEnabled = 1;
+}
+
+// task execution time
+void Sim_Burn(DWORD counts)
+{
+    while(counts-- > 0)
+    {
+        Sim_Step();
+    }
+}
+
+volatile DWORD *Sim_Reg(volatile DWORD *reg)
+{
+    Sim_Step();
+
+    // writing TMR4 restarts the count of the running period
+    if(reg == &Sim_TMR4)
+    {
+        Sim.count = 0;
+    }
+    return reg;
+}
+
+volatile SimIFS0bits *Sim_IFS0(void)
+{
+    Sim_Step();
+    return &Sim_IFS0bits;
+}
+
+unsigned int INTDisableInterrupts(void)
+{
+    unsigned int status = Sim_intEnabled;
+
+    Sim_Step();
+    Sim_intEnabled = 0;
+    return status;
+}
+
+void INTRestoreInterrupts(unsigned int status)
+{
+    Sim_intEnabled = status;
+    Sim_Step();
+}
+
+DWORD ReadCoreTimer(void)
+{
+    return Sim_core;
+}
@@ -0,0 +1,32 @@
+// simulated PIC32 timer hardware for the host tests
+// (C) 2023-09-09 by Daniel Porzig
+
+#ifndef _SIM_H_
+#define _SIM_H_
+
+#include <plib.h>
+
+// Timer4 counts per scheduler tick, see SCHEDULER_TICK_PERIOD
+#define SIM_TICK_PERIOD     2500
+
+// core timer counts per Timer4 count (SYSCLK/2 vs. PBCLK/64)
+#define SIM_CORE_PER_T4     32
+
+typedef struct
+{
+    DWORD ticks;            // elapsed scheduler ticks (wall clock)
+    DWORD count;            // Timer4 counts since the last match or TMR4 write
+    DWORD matches;          // period matches of Timer4
+    DWORD longMatches;      // matches after an extended (tickless) period
+    DWORD isrs;             // simulated interrupts
+    DWORD isrRate;          // 1 in isrRate register accesses with interrupts on is interrupted
+    DWORD isrMax;           // longest simulated interrupt in Timer4 counts
+}SimStruct;
+
+extern SimStruct Sim;
+
+void Sim_Init(DWORD seed, DWORD isrRate, DWORD isrMax);
+void Sim_Burn(DWORD counts);
+DWORD Sim_Rand(void);
+
+#endif
@@ -0,0 +1,26 @@
+// host stand-in for the Microchip type definitions (fixed width on 64 bit hosts)
+// (C) 2023-09-09 by Daniel Porzig
+
+#ifndef __GENERIC_TYPE_DEFS_H_
+#define __GENERIC_TYPE_DEFS_H_
+
+#include <stdint.h>
+
+typedef uint8_t     BYTE;
+typedef uint16_t    WORD;
+typedef uint32_t    DWORD;
+typedef uint64_t    QWORD;
+typedef uint32_t    UINT;
+typedef uint8_t     UINT8;
+typedef uint16_t    UINT16;
+typedef uint32_t    UINT32;
+typedef uint64_t    UINT64;
+typedef int32_t     INT;
+typedef int8_t      INT8;
+typedef int16_t     INT16;
+typedef int32_t     INT32;
+typedef int64_t     INT64;
+typedef char        CHAR8;
+typedef enum _BOOL { FALSE = 0, TRUE } BOOL;
+
+#endif
@@ -0,0 +1,2 @@
+// case shim, the XC32 build on Windows resolves "circbuffer.h" to CircBuffer.h
+#include "../../Common/CircBuffer.h"
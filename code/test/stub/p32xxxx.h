@@ -0,0 +1 @@
+// host stand-in, the simulated registers are declared in plib.h
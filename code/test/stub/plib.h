@@ -0,0 +1,40 @@
+// host stand-in for the PIC32 peripheral library used by the host tests.
+// Timer4, the core timer and the interrupt enable are simulated in sim.c,
+// every register access advances the simulated time
+// (C) 2023-09-09 by Daniel Porzig
+
+#ifndef _PLIB_H_
+#define _PLIB_H_
+
+#include <GenericTypeDefs.h>
+#include <string.h>
+
+#define __ISR(v, ipl)
+#define _TIMER_4_VECTOR     16
+
+typedef struct { unsigned T4IF:1; } SimIFS0bits;
+typedef struct { unsigned T4IE:1; } SimIEC0bits;
+typedef struct { unsigned T4IP:3; } SimIPC4bits;
+typedef struct { unsigned TCKPS:3; unsigned TON:1; } SimT4CONbits;
+
+volatile DWORD *Sim_Reg(volatile DWORD *reg);
+volatile SimIFS0bits *Sim_IFS0(void);
+
+extern volatile DWORD Sim_TMR4, Sim_PR4, Sim_T4CON;
+extern volatile SimIEC0bits Sim_IEC0;
+extern volatile SimIPC4bits Sim_IPC4;
+extern volatile SimT4CONbits Sim_T4CONbits;
+
+#define TMR4            (*Sim_Reg(&Sim_TMR4))
+#define PR4             (*Sim_Reg(&Sim_PR4))
+#define T4CON           (*Sim_Reg(&Sim_T4CON))
+#define IFS0bits        (*Sim_IFS0())
+#define IEC0bits        Sim_IEC0
+#define IPC4bits        Sim_IPC4
+#define T4CONbits       Sim_T4CONbits
+
+unsigned int INTDisableInterrupts(void);
+void INTRestoreInterrupts(unsigned int status);
+DWORD ReadCoreTimer(void);
+
+#endif
@@ -0,0 +1 @@
+// host stand-in, interrupt attributes are defined in plib.h
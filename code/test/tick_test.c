@@ -0,0 +1,134 @@
+// tickless scheduler test: tasks and software timers must fire on the same
+// ticks as in busy wait mode, i.e. exactly <skiprate> ticks after their last
+// call, while Timer4 and interrupts are simulated (sim.c)
+// (C) 2023-09-09 by Daniel Porzig
+
+#include <stdio.h>
+#include "sim.h"
+#include "TaskScheduler.h"
+#include "SoftTimer.h"
+
+#define TEST_TASKS          6
+#define TEST_TIMERS         4
+#define TEST_TICKS          2000000
+
+static DWORD taskDue[TEST_TASKS];
+static DWORD taskCalls[TEST_TASKS];
+static DWORD timerDue[TEST_TIMERS];
+static DWORD timerCalls;
+static SoftTimerStruct timers[TEST_TIMERS];
+static DWORD errors;
+
+// tick of the running Scheduler_Run(). a task may overrun the tick, so the
+// wall clock Sim.ticks can already be ahead when the next task is called
+static DWORD runTick;
+
+// skiprate patterns: bursts of single ticks, short, a few seconds, beyond
+// the longest tickless sleep
+static DWORD Test_Skiprate(BYTE id)
+{
+    switch(id)
+    {
+    case 0:     return (Sim_Rand() % 4 == 0) ? 1 : 20 + Sim_Rand() % 200;
+    case 1:     return 13;
+    case 2:     return 1 + Sim_Rand() % 40;
+    case 3:     return 250;
+    case 4:     return 1 + Sim_Rand() % 2000;
+    default:    return 7500;
+    }
+}
+
+static void Test_TimerExpired(void)
+{
+    BYTE i;
+
+    for(i=0; i<TEST_TIMERS; i++)
+    {
+        if(SoftTimer_Expired(&timers[i]))
+        {
+            timerCalls++;
+            if(runTick != timerDue[i])
+            {
+                printf("timer %u: expired on tick %u, due %u\n", i, runTick, timerDue[i]);
+                errors++;
+            }
+        }
+    }
+}
+
+static void Test_Task(void *pvParameters, DWORD *skiprate)
+{
+    BYTE id = (BYTE)(size_t)pvParameters;
+    BYTE i;
+    DWORD n;
+
+    if(taskCalls[id]++ > 0 && runTick != taskDue[id])
+    {
+        printf("task %u: called on tick %u, due %u\n", id, runTick, taskDue[id]);
+        errors++;
+    }
+
+    *skiprate = Test_Skiprate(id);
+    taskDue[id] = runTick + *skiprate;
+
+    // (re)start software timers that are not running
+    if(id == 2)
+    {
+        for(i=0; i<TEST_TIMERS; i++)
+        {
+            if(!SoftTimer_IsRunning(&timers[i]))
+            {
+                n = 1 + Sim_Rand() % (i == 0 ? 60 : 5000);
+                SoftTimer_Start(&timers[i], n, 0, Test_TimerExpired);
+                timerDue[i] = runTick + n;
+            }
+        }
+    }
+
+    // execution time, all tasks together stay below one tick
+    Sim_Burn(Sim_Rand() % 200);
+}
+
+static int Test_Run(DWORD seed, DWORD isrRate, DWORD isrMax)
+{
+    BYTE i;
+
+    Sim_Init(seed, isrRate, isrMax);
+    memset(taskCalls, 0, sizeof(taskCalls));
+    memset(timers, 0, sizeof(timers));
+    timerCalls = 0;
+    errors = 0;
+
+    Scheduler_Init();
+    for(i=0; i<TEST_TASKS; i++)
+    {
+        Scheduler_AddTask(i, Test_Task, (void*)(size_t)i, SCHEDULER_PRIO_REALTIME, i);
+    }
+
+    while(Sim.ticks < TEST_TICKS && errors < 10)
+    {
+        runTick = Sim.ticks;
+        Scheduler_Run();
+    }
+
+    printf("seed %u, interrupts 1/%u up to %u counts: %u ticks, %u timer matches (%u extended), %u interrupts, %u task calls, %u timer expiries, %u errors\n",
+           seed, isrRate, isrMax, Sim.ticks, Sim.matches, Sim.longMatches, Sim.isrs,
+           taskCalls[0] + taskCalls[1] + taskCalls[2] + taskCalls[3] + taskCalls[4] + taskCalls[5],
+           timerCalls, errors);
+
+    return errors != 0;
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    // no interrupts, short interrupts, interrupts up to almost a full tick
+    fail |= Test_Run(1, 0, 1);
+    fail |= Test_Run(2, 50, 200);
+    fail |= Test_Run(3, 200, SIM_TICK_PERIOD - 100);
+    fail |= Test_Run(4, 20, SIM_TICK_PERIOD);
+
+    printf(fail ? "FAILED\n" : "passed\n");
+    return fail;
+}
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+# decoder for the binary log records of Common/Log.c (LOG_BINARY_OUTPUT)
+# (C) 2023-09-09 by Daniel Porzig
+#
+# usage: logdecode.py <firmware.elf> [capture file | serial port [baud]]
+#
+# Reads the debug console stream (from a file, a serial port or stdin),
+# prints plain text as is and replaces every log record frame by its
+# formatted text. Format strings and "%s" arguments are read from the ELF.
+
+import re
+import struct
+import sys
+
+SYNC = b'\x1bL'
+RECORD = struct.Struct('<I4IIBBH')      # fmt, arg[4], timestamp, module, level, seq
+FRAME_LEN = len(SYNC) + RECORD.size + 1
+
+CORE_TIMER_HZ = 20000000                # SYSCLK / 2
+
+MODULES = ['SYS', 'BTCOM', 'FANCTL', 'DEVCTL', 'TIMEKEEPER']
+LEVELS = ['OFF', 'ERR', 'WRN', 'INF', 'DBG']
+
+SPEC = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(?:l|h)*([diuxXocsfeEgG%])')
+
+
+class Elf:
+    """minimal ELF32 little endian reader, maps addresses to section data"""
+
+    def __init__(self, path):
+        data = open(path, 'rb').read()
+        if data[:4] != b'\x7fELF' or data[4] != 1 or data[5] != 1:
+            raise ValueError('%s: not a 32 bit little endian ELF file' % path)
+        shoff, = struct.unpack_from('<I', data, 0x20)
+        shentsize, shnum = struct.unpack_from('<HH', data, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            _, stype, flags, addr, offset, size = struct.unpack_from('<IIIIII', data, shoff + i * shentsize)
+            # allocated sections with file contents (PROGBITS)
+            if stype == 1 and flags & 0x2 and size:
+                self.sections.append((addr, data[offset:offset + size]))
+
+    def string(self, addr):
+        for base, blob in self.sections:
+            if base <= addr < base + len(blob):
+                end = blob.find(b'\0', addr - base)
+                return blob[addr - base:end].decode('latin-1')
+        return None
+
+
+def format_record(elf, rec):
+    fmt_addr, a0, a1, a2, a3, ts, module, level, seq = rec
+    args = [a0, a1, a2, a3]
+    fmt = elf.string(fmt_addr)
+    if fmt is None:
+        return '<unknown format 0x%08X>' % fmt_addr
+
+    def conv(m):
+        flags, c = m.group(1), m.group(2)
+        if c == '%':
+            return '%'
+        v = args.pop(0) if args else 0
+        if c in 'fFeEgG':
+            v = struct.unpack('<f', struct.pack('<I', v))[0]
+        elif c in 'dic':
+            v = v - (1 << 32) if v & 0x80000000 else v
+            if c == 'c':
+                return chr(v & 0xFF)
+        elif c == 's':
+            v = elf.string(v)
+            if v is None:
+                v = '<?>'
+        return ('%' + flags + c) % v
+
+    text = SPEC.sub(conv, fmt)
+    prefix = '[%10.6f %s/%s #%u] ' % (ts / CORE_TIMER_HZ,
+                                       MODULES[module] if module < len(MODULES) else module,
+                                       LEVELS[level] if level < len(LEVELS) else level, seq)
+    return prefix + text.replace('\n\r', '\n').replace('\r\n', '\n').lstrip('\n')
+
+
+def decode(elf, stream, out):
+    buf = b''
+    nextseq = None
+    while True:
+        chunk = stream.read(1) if hasattr(stream, 'in_waiting') else stream.read(4096)
+        if not chunk:
+            break
+        buf += chunk
+        while True:
+            i = buf.find(SYNC)
+            if i < 0:
+                # keep a possible first sync byte
+                keep = 1 if buf.endswith(SYNC[:1]) else 0
+                out.write(buf[:len(buf) - keep].decode('latin-1'))
+                buf = buf[len(buf) - keep:]
+                break
+            out.write(buf[:i].decode('latin-1'))
+            buf = buf[i:]
+            if len(buf) < FRAME_LEN:
+                break
+            body = buf[len(SYNC):FRAME_LEN - 1]
+            if sum(body) & 0xFF != buf[FRAME_LEN - 1]:
+                # not a record, pass the sync byte through as text
+                out.write(buf[:1].decode('latin-1'))
+                buf = buf[1:]
+                continue
+            rec = RECORD.unpack(body)
+            seq = rec[-1]
+            if nextseq is not None and seq != nextseq:
+                out.write('\n--- %u records lost ---\n' % ((seq - nextseq) & 0xFFFF))
+            nextseq = (seq + 1) & 0xFFFF
+            out.write('\n' + format_record(elf, rec) + '\n')
+            buf = buf[FRAME_LEN:]
+        out.flush()
+    out.write(buf.decode('latin-1'))
+
+
+def main():
+    if len(sys.argv) < 2:
+        print('usage: logdecode.py <firmware.elf> [capture file | serial port [baud]]')
+        sys.exit(1)
+
+    elf = Elf(sys.argv[1])
+
+    if len(sys.argv) < 3:
+        stream = sys.stdin.buffer
+    elif sys.argv[2].startswith(('/dev/', 'COM')):
+        import serial   # pyserial, only needed for live decoding
+        baud = int(sys.argv[3]) if len(sys.argv) > 3 else 115200
+        stream = serial.Serial(sys.argv[2], baud)
+    else:
+        stream = open(sys.argv[2], 'rb')
+
+    decode(elf, stream, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,294 @@
+#!/usr/bin/env python3
+# firmware image packer for the BLE bootloader
+# (C) 2023-09-09 by Daniel Porzig
+#
+# usage: otapack.py <app.hex> <image.bin> [--raw | --base <installed.hex>]
+#
+# Extracts the application from the production hex file (APP_FLASH_START_ADDRESS
+# up to the last programmed byte), builds the 64 byte header block and
+# appends the image, LZSS compressed (see Common/LZSS.h) unless --raw is
+# given. The output is sent as is in PROGRAM_BLOCK_SIZE blocks, block 0 is
+# the header.
+#
+# With --base a delta image is built, which the bootloader applies to the
+# installed image (given by its hex file, checked by CRC before anything is
+# erased): a sequence of
+#   DELTA_OP_COPY src(3) len(2)     copy from the installed image
+#   DELTA_OP_DATA len(2) data...
+# operations, LZSS compressed. The bootloader rewrites the flash page by page
+# and keeps the old contents of the last DELTA_BACKUP_PAGES rewritten pages,
+# copies may only read from these, the page being written or behind it.
+
+import struct
+import sys
+import time
+
+APP_FLASH_START_ADDRESS = 0x9D008180
+APP_FLASH_END_ADDRESS = 0x9D01FFFF
+APP_FWSTRING_BASE_ADDRESS = 0x9D00F000
+
+FIRMWARE_IMG_SIGNATURE = 0xA2F6
+IMAGE_FORMAT_RAW = 0x00
+IMAGE_FORMAT_LZSS = 0x4C
+IMAGE_FORMAT_DELTA = 0x44
+
+DELTA_OP_COPY = 0x00
+DELTA_OP_DATA = 0x01
+DELTA_MIN_COPY = 8              # shorter matches are sent as data
+DELTA_MAX_LEN = 0xFFFF
+FLASH_PAGE_SIZE = 1024
+DELTA_BACKUP_PAGES = 8
+
+PROGRAM_BLOCK_SIZE = 64
+
+# imageHeader, #pragma pack(2): signature, size, builddate, crc16, FWrevstr, format,
+# baseCrc16, baseSize
+HEADER = struct.Struct('<HIqH13sBHI')
+
+LZSS_WINDOW_SIZE = 1024
+LZSS_MIN_MATCH = 3
+LZSS_MAX_MATCH = LZSS_MIN_MATCH + 63
+LZSS_CHAIN = 256                # candidates checked per position
+
+
+def phys(addr):
+    return addr & 0x1FFFFFFF
+
+
+def read_hex(path):
+    """returns {physical address: byte} of an Intel hex file"""
+    mem = {}
+    base = 0
+    for n, line in enumerate(open(path), 1):
+        line = line.strip()
+        if not line:
+            continue
+        if line[0] != ':':
+            raise ValueError('%s:%d: not an Intel hex record' % (path, n))
+        rec = bytes.fromhex(line[1:])
+        if sum(rec) & 0xFF:
+            raise ValueError('%s:%d: checksum error' % (path, n))
+        count, addr, rtype = rec[0], (rec[1] << 8) | rec[2], rec[3]
+        data = rec[4:4 + count]
+        if rtype == 0x00:
+            for i, b in enumerate(data):
+                mem[base + addr + i] = b
+        elif rtype == 0x01:
+            break
+        elif rtype == 0x02:
+            base = ((data[0] << 8) | data[1]) << 4
+        elif rtype == 0x04:
+            base = ((data[0] << 8) | data[1]) << 16
+    return mem
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT-FALSE, as Common/CRC16.c"""
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def lzss_compress(data):
+    out = bytearray()
+    chains = {}
+    i = 0
+    n = len(data)
+    while i < n:
+        flagpos = len(out)
+        out.append(0)
+        flags = 0
+        for bit in range(8):
+            if i >= n:
+                break
+            best_len, best_dist = 0, 0
+            if i + LZSS_MIN_MATCH <= n:
+                key = data[i:i + LZSS_MIN_MATCH]
+                maxlen = min(LZSS_MAX_MATCH, n - i)
+                for j in reversed(chains.get(key, ())):
+                    if i - j > LZSS_WINDOW_SIZE:
+                        break
+                    length = LZSS_MIN_MATCH
+                    while length < maxlen and data[j + length] == data[i + length]:
+                        length += 1
+                    if length > best_len:
+                        best_len, best_dist = length, i - j
+                        if length == maxlen:
+                            break
+            if best_len >= LZSS_MIN_MATCH:
+                d = best_dist - 1
+                out.append(d >> 2)
+                out.append(((d & 3) << 6) | (best_len - LZSS_MIN_MATCH))
+                step = best_len
+            else:
+                flags |= 1 << bit
+                out.append(data[i])
+                step = 1
+            for k in range(i, min(i + step, n - LZSS_MIN_MATCH + 1)):
+                chain = chains.setdefault(data[k:k + LZSS_MIN_MATCH], [])
+                chain.append(k)
+                if len(chain) > LZSS_CHAIN:
+                    del chain[0]
+            i += step
+        out[flagpos] = flags
+    return bytes(out)
+
+
+def delta_minsrc(pos):
+    """lowest source offset a copy to image offset <pos> may read: the pages
+    before the one being written are already rewritten, the bootloader keeps
+    the last DELTA_BACKUP_PAGES of them"""
+    page = (APP_FLASH_START_ADDRESS + pos) & ~(FLASH_PAGE_SIZE - 1)
+    return max(0, page - DELTA_BACKUP_PAGES * FLASH_PAGE_SIZE - APP_FLASH_START_ADDRESS)
+
+
+def delta_encode(base, image):
+    index = {}
+    for j in range(len(base) - DELTA_MIN_COPY + 1):
+        index.setdefault(base[j:j + DELTA_MIN_COPY], []).append(j)
+
+    ops = []
+    literal = bytearray()
+    shift = 0                   # source - destination of the last copy
+    i = 0
+
+    def flush_literal():
+        for k in range(0, len(literal), DELTA_MAX_LEN):
+            part = literal[k:k + DELTA_MAX_LEN]
+            ops.append(struct.pack('>BH', DELTA_OP_DATA, len(part)) + part)
+        literal.clear()
+
+    while i < len(image):
+        best_len, best_src = 0, 0
+        cands = index.get(image[i:i + DELTA_MIN_COPY], [])
+        # the continuation of the last copy first, then the closest ones
+        tries = [i + shift] + sorted(cands, key=lambda j: abs(j - i - shift))[:32]
+        for j in tries:
+            if j < delta_minsrc(i) or j >= len(base):
+                continue
+            length = 0
+            while (i + length < len(image) and j + length < len(base) and length < DELTA_MAX_LEN and
+                   base[j + length] == image[i + length] and j + length >= delta_minsrc(i + length)):
+                length += 1
+            if length > best_len:
+                best_len, best_src = length, j
+        if best_len >= DELTA_MIN_COPY:
+            flush_literal()
+            ops.append(struct.pack('>BBHH', DELTA_OP_COPY, best_src >> 16, best_src & 0xFFFF, best_len))
+            shift = best_src - i
+            i += best_len
+        else:
+            literal.append(image[i])
+            i += 1
+    flush_literal()
+    return b''.join(ops)
+
+
+def delta_apply(base, delta, size):
+    """reference of the bootloader's delta decoding, checks the page order"""
+    out = bytearray()
+    i = 0
+    while i < len(delta):
+        if delta[i] == DELTA_OP_COPY:
+            src = (delta[i + 1] << 16) | (delta[i + 2] << 8) | delta[i + 3]
+            length = (delta[i + 4] << 8) | delta[i + 5]
+            i += 6
+            for k in range(length):
+                if src + k < delta_minsrc(len(out)):
+                    raise ValueError('delta reads a rewritten page')
+                out.append(base[src + k])
+        else:
+            length = (delta[i + 1] << 8) | delta[i + 2]
+            out += delta[i + 3:i + 3 + length]
+            i += 3 + length
+    return bytes(out[:size])
+
+
+def lzss_decompress(data, size):
+    """reference decoder, used to check the compressed stream"""
+    out = bytearray()
+    i = 0
+    while len(out) < size:
+        flags = data[i]
+        i += 1
+        for bit in range(8):
+            if len(out) >= size:
+                break
+            if flags & (1 << bit):
+                out.append(data[i])
+                i += 1
+            else:
+                d = ((data[i] << 2) | (data[i + 1] >> 6)) + 1
+                length = (data[i + 1] & 0x3F) + LZSS_MIN_MATCH
+                i += 2
+                for _ in range(length):
+                    out.append(out[-d])
+    return bytes(out[:size])
+
+
+def read_image(path):
+    """returns the application image of a hex file and its mapped memory"""
+    mem = read_hex(path)
+    start, end = phys(APP_FLASH_START_ADDRESS), phys(APP_FLASH_END_ADDRESS)
+    used = [a for a in mem if start <= a <= end]
+    if not used:
+        sys.exit('%s: no data in the application flash region' % path)
+
+    size = (max(used) - start + 4) & ~3
+    return bytes(mem.get(start + i, 0xFF) for i in range(size)), mem
+
+
+def main():
+    argv = sys.argv[1:]
+    base = None
+    if '--base' in argv:
+        k = argv.index('--base')
+        if k + 1 >= len(argv):
+            sys.exit('usage: otapack.py <app.hex> <image.bin> [--raw | --base <installed.hex>]')
+        base, _ = read_image(argv[k + 1])
+        del argv[k:k + 2]
+    args = [a for a in argv if not a.startswith('--')]
+    if len(args) != 2:
+        sys.exit('usage: otapack.py <app.hex> <image.bin> [--raw | --base <installed.hex>]')
+    raw = '--raw' in argv
+
+    image, mem = read_image(args[0])
+    size = len(image)
+
+    fwstr = bytes(mem.get(phys(APP_FWSTRING_BASE_ADDRESS) + i, 0) for i in range(12))
+
+    basecrc, basesize = 0, 0
+    if base is not None:
+        delta = delta_encode(base, image)
+        if delta_apply(base, delta, size) != image:
+            sys.exit('internal error: delta round trip failed')
+        payload, fmt = lzss_compress(delta), IMAGE_FORMAT_DELTA
+        basecrc, basesize = crc16(base), len(base)
+    elif raw:
+        payload, fmt = image, IMAGE_FORMAT_RAW
+    else:
+        payload, fmt = lzss_compress(image), IMAGE_FORMAT_LZSS
+        if lzss_decompress(payload, size) != image:
+            sys.exit('internal error: LZSS round trip failed')
+
+    header = HEADER.pack(FIRMWARE_IMG_SIGNATURE, size, int(time.time()), crc16(image), fwstr, fmt,
+                         basecrc, basesize)
+    header += bytes(PROGRAM_BLOCK_SIZE - len(header))
+
+    with open(args[1], 'wb') as f:
+        f.write(header + payload)
+
+    blocks = (len(payload) + PROGRAM_BLOCK_SIZE - 1) // PROGRAM_BLOCK_SIZE
+    print('image:      %u bytes, CRC16 %04X, "%s"' % (size, crc16(image), fwstr.decode('latin-1').rstrip('\0')))
+    if base is not None:
+        print('base:       %u bytes, CRC16 %04X' % (basesize, basecrc))
+    print('payload:    %u bytes (%s), %u blocks' % (len(payload), {IMAGE_FORMAT_RAW: 'raw', IMAGE_FORMAT_LZSS: 'LZSS',
+                                                              IMAGE_FORMAT_DELTA: 'LZSS delta'}[fmt], blocks))
+    print('ratio:      %.1f %%' % (100.0 * len(payload) / size))
+
+
+if __name__ == '__main__':
+    main()